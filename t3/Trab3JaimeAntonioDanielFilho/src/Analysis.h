@@ -0,0 +1,431 @@
+/*********************************************************************
+// Analysis.h
+// Análise da matriz X exibida no painel de análise: o polinômio
+// característico e as bases do núcleo, do espaço coluna e do espaço linha.
+// O polinômio vem da redução de X à forma de Hessenberg por reflexões de
+// Householder, cujo polinômio sai de uma recorrência sobre as colunas, tudo
+// em O(n^3). As bases são lidas da forma escalonada reduzida do Gauss
+// Jordan de Operations.h, sem nenhuma eliminação além dela. A análise só é
+// calculada quando o painel está aberto, em segundo plano.
+// *********************************************************************/
+
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Operations.h"
+#include "Task.h"
+
+// Quantidade máxima de vetores descritos de cada base
+#define ANL_VECTORS_SHOWN 16
+
+typedef struct
+{
+    // Cópia da matriz X e, caso já exista, a sua forma escalonada reduzida
+    int rows, columns;
+    double *x;
+    double *reduced;
+
+    // Pedido da forma reduzida exata e, depois dela, se a forma reduzida é de fato exata
+    // (matriz inteira), caso em que qualquer valor não nulo é um pivo
+    bool exact;
+
+    bool success;
+
+    // Coeficientes de det(tI - X), do termo constante ao de grau n (apenas quadradas)
+    double *polynomial;
+
+    // Coluna do pivo de cada uma das rank primeiras linhas da forma reduzida
+    int rank;
+    int *pivots;
+
+    // Bases, um vetor após o outro: columns - rank vetores do núcleo (de tamanho columns),
+    // rank colunas de X (de tamanho rows) e rank linhas da forma reduzida (de tamanho columns)
+    double *nullspace;
+    double *columnSpace;
+    double *rowSpace;
+} Analysis;
+
+// Aloca uma análise com espaço para a cópia de uma matriz de tais dimensões
+Analysis *CreateAnalysis(int rows, int columns)
+{
+    Analysis *analysis = (Analysis *)malloc(sizeof(Analysis));
+
+    analysis->rows = rows;
+    analysis->columns = columns;
+    analysis->x = (double *)malloc(((size_t)rows * columns + 1) * sizeof(double));
+    analysis->reduced = NULL;
+    analysis->exact = false;
+
+    analysis->success = false;
+
+    analysis->polynomial = NULL;
+
+    analysis->rank = 0;
+    analysis->pivots = NULL;
+
+    analysis->nullspace = NULL;
+    analysis->columnSpace = NULL;
+    analysis->rowSpace = NULL;
+
+    return analysis;
+}
+
+// Libera a memória ocupada pela análise
+void FreeAnalysis(void *work)
+{
+    Analysis *analysis = (Analysis *)work;
+
+    free(analysis->x);
+    free(analysis->reduced);
+    free(analysis->polynomial);
+    free(analysis->pivots);
+    free(analysis->nullspace);
+    free(analysis->columnSpace);
+    free(analysis->rowSpace);
+    free(analysis);
+}
+
+// Reduz a matriz a (size x size) à forma de Hessenberg superior por reflexões de Householder
+// A matriz resultante é semelhante à original e tem zeros abaixo da subdiagonal
+// Retorna falso caso a tarefa seja cancelada
+bool ReduceHessenberg(double *a, int size, Task *task = NULL)
+{
+    double *v = (double *)malloc((size + 1) * sizeof(double));
+    double *w = (double *)malloc((size + 1) * sizeof(double));
+
+    for (int k = 0; k + 2 < size; k++)
+    {
+        if (IsTaskCancelled(task))
+            break;
+
+        // Reflexão que zera a coluna k abaixo da subdiagonal
+        double norm = 0;
+
+        for (int i = k + 1; i < size; i++)
+        {
+            v[i] = a[(size_t)i * size + k];
+            norm += v[i] * v[i];
+        }
+
+        norm = sqrt(norm);
+
+        double alpha = v[k + 1] > 0 ? -norm : norm;
+        v[k + 1] -= alpha;
+
+        double length = 0;
+
+        for (int i = k + 1; i < size; i++)
+            length += v[i] * v[i];
+
+        if (length == 0)
+            continue;
+
+        double factor = 2 / length;
+
+        // Pela esquerda: a = (I - factor v v^T) a, sobre as linhas k + 1 em diante
+        for (int j = k; j < size; j++)
+            w[j] = 0;
+
+        for (int i = k + 1; i < size; i++)
+        {
+            const double *row = a + (size_t)i * size;
+
+            for (int j = k; j < size; j++)
+                w[j] += v[i] * row[j];
+        }
+
+        for (int i = k + 1; i < size; i++)
+        {
+            double *row = a + (size_t)i * size;
+            double scale = factor * v[i];
+
+            for (int j = k; j < size; j++)
+                row[j] -= scale * w[j];
+        }
+
+        // Pela direita: a = a (I - factor v v^T), sobre as colunas k + 1 em diante
+        for (int i = 0; i < size; i++)
+        {
+            double *row = a + (size_t)i * size;
+            double dot = 0;
+
+            for (int j = k + 1; j < size; j++)
+                dot += row[j] * v[j];
+
+            dot *= factor;
+
+            for (int j = k + 1; j < size; j++)
+                row[j] -= dot * v[j];
+        }
+
+        // Os elementos abaixo da subdiagonal já são zero, a menos do arredondamento
+        a[(size_t)(k + 1) * size + k] = alpha;
+
+        for (int i = k + 2; i < size; i++)
+            a[(size_t)i * size + k] = 0;
+
+        SetTaskProgress(task, (float)(k + 1) / size);
+    }
+
+    free(v);
+    free(w);
+
+    return !IsTaskCancelled(task);
+}
+
+// Calcula os coeficientes de det(tI - h), do termo constante ao de grau size, da matriz de Hessenberg h
+// Sendo p_m o polinômio do bloco m x m do canto superior esquerdo (p_0 = 1), vale a recorrência
+// p_m = (t - h_mm) p_m-1 - soma de i = 1 até m - 1 de h_im (h_i+1,i ... h_m,m-1) p_i-1
+// Retorna falso caso a tarefa seja cancelada
+bool HessenbergPolynomial(const double *h, int size, double *coefficients, Task *task = NULL)
+{
+    // Os polinômios p_0 até p_size, com size + 1 coeficientes cada
+    size_t stride = (size_t)size + 1;
+    double *p = (double *)calloc(stride * stride, sizeof(double));
+
+    p[0] = 1;
+
+    for (int m = 1; m <= size && !IsTaskCancelled(task); m++)
+    {
+        double *current = p + m * stride;
+        const double *previous = p + (m - 1) * stride;
+
+        double diagonal = h[(size_t)(m - 1) * size + m - 1];
+
+        for (int d = 0; d < m; d++)
+            current[d + 1] += previous[d];
+
+        for (int d = 0; d < m; d++)
+            current[d] -= diagonal * previous[d];
+
+        // Produto dos elementos da subdiagonal de i + 1 até m, acumulado de baixo para cima
+        double product = 1;
+
+        for (int i = m - 1; i >= 1; i--)
+        {
+            product *= h[(size_t)i * size + i - 1];
+
+            if (product == 0)
+                break;
+
+            double coefficient = h[(size_t)(i - 1) * size + m - 1] * product;
+            const double *lower = p + (i - 1) * stride;
+
+            for (int d = 0; d < i; d++)
+                current[d] -= coefficient * lower[d];
+        }
+
+        SetTaskProgress(task, (float)m / size);
+    }
+
+    memcpy(coefficients, p + size * stride, stride * sizeof(double));
+    free(p);
+
+    return !IsTaskCancelled(task);
+}
+
+// Lê as bases da forma escalonada reduzida da matriz X
+// Cada coluna livre f dá um vetor do núcleo com 1 na posição f e o oposto da coluna f
+// da forma reduzida nas posições dos pivôs; as colunas dos pivôs em X formam o espaço coluna
+// e as linhas não nulas da forma reduzida, o espaço linha
+void ReadReducedBases(Analysis *analysis)
+{
+    int rows = analysis->rows;
+    int columns = analysis->columns;
+    const double *reduced = analysis->reduced;
+    double threshold = analysis->exact ? 0 : ZERO_THRESHOLD;
+
+    analysis->pivots = (int *)malloc((rows + 1) * sizeof(int));
+    bool *freeColumns = (bool *)malloc((columns + 1) * sizeof(bool));
+
+    for (int j = 0; j < columns; j++)
+        freeColumns[j] = true;
+
+    // As linhas não nulas vêm primeiro e o pivo de cada uma é o seu primeiro elemento não nulo
+    int rank = 0;
+
+    for (int i = 0; i < rows; i++)
+    {
+        int pivot = -1;
+
+        for (int j = 0; j < columns && pivot == -1; j++)
+        {
+            if (fabs(reduced[(size_t)i * columns + j]) > threshold)
+                pivot = j;
+        }
+
+        if (pivot == -1)
+            break;
+
+        analysis->pivots[rank++] = pivot;
+        freeColumns[pivot] = false;
+    }
+
+    analysis->rank = rank;
+
+    int nullity = columns - rank;
+
+    analysis->nullspace = (double *)calloc((size_t)nullity * columns + 1, sizeof(double));
+    analysis->columnSpace = (double *)malloc(((size_t)rank * rows + 1) * sizeof(double));
+    analysis->rowSpace = (double *)malloc(((size_t)rank * columns + 1) * sizeof(double));
+
+    double *vector = analysis->nullspace;
+
+    for (int f = 0; f < columns; f++)
+    {
+        if (!freeColumns[f])
+            continue;
+
+        vector[f] = 1;
+
+        for (int r = 0; r < rank; r++)
+            vector[analysis->pivots[r]] = -reduced[(size_t)r * columns + f];
+
+        vector += columns;
+    }
+
+    for (int r = 0; r < rank; r++)
+    {
+        for (int i = 0; i < rows; i++)
+            analysis->columnSpace[(size_t)r * rows + i] = analysis->x[(size_t)i * columns + analysis->pivots[r]];
+    }
+
+    memcpy(analysis->rowSpace, reduced, (size_t)rank * columns * sizeof(double));
+
+    free(freeColumns);
+}
+
+// Calcula a análise da matriz X, reaproveitando a forma reduzida já fornecida
+void ExecuteAnalysis(void *work, Task *task)
+{
+    Analysis *analysis = (Analysis *)work;
+
+    int rows = analysis->rows;
+    int columns = analysis->columns;
+    bool square = rows == columns;
+
+    // A eliminação (quando necessária) e a redução de Hessenberg dividem o progresso
+    float split = analysis->reduced != NULL ? 0 : square ? 0.3f : 1;
+
+    if (analysis->reduced == NULL)
+    {
+        Job *job = CreateJob(OPERATION_GAUSS_JORDAN, rows, columns, 0, 0);
+        job->exact = analysis->exact;
+
+        memcpy(job->x, analysis->x, (size_t)rows * columns * sizeof(double));
+        DetectStructure(job->x, rows, columns, &job->structureX);
+
+        SetTaskStage(task, 0, split);
+        GaussJordan(job, task);
+
+        analysis->reduced = job->z;
+        analysis->exact = job->fractions != NULL;
+        job->z = NULL;
+
+        FreeJob(job);
+    }
+
+    if (IsTaskCancelled(task))
+        return;
+
+    ReadReducedBases(analysis);
+
+    if (square)
+    {
+        double *h = (double *)malloc(((size_t)rows * rows + 1) * sizeof(double));
+        memcpy(h, analysis->x, (size_t)rows * rows * sizeof(double));
+
+        analysis->polynomial = (double *)malloc((rows + 1) * sizeof(double));
+
+        SetTaskStage(task, split, split + (1 - split) * 0.8f);
+        bool reduced = ReduceHessenberg(h, rows, task);
+
+        SetTaskStage(task, split + (1 - split) * 0.8f, 1);
+        bool finished = reduced && HessenbergPolynomial(h, rows, analysis->polynomial, task);
+
+        free(h);
+
+        if (!finished)
+            return;
+    }
+
+    analysis->success = true;
+}
+
+// Escreve um número de forma compacta no fim do texto, sem passar de size caracteres
+void AppendNumber(char *text, size_t size, const char *format, double value)
+{
+    size_t length = strlen(text);
+
+    if (length + 1 < size)
+        snprintf(text + length, size - length, format, value);
+}
+
+// Escreve o polinômio característico (por exemplo "t^2 - 5t - 2"), sem os termos nulos
+void DescribePolynomial(const Analysis *analysis, char *text, size_t size)
+{
+    int degree = analysis->rows;
+
+    text[0] = '\0';
+
+    for (int d = degree; d >= 0 && strlen(text) + 1 < size; d--)
+    {
+        double coefficient = analysis->polynomial[d];
+
+        if (coefficient == 0 && d < degree)
+            continue;
+
+        double magnitude = fabs(coefficient);
+        bool first = d == degree;
+
+        if (!first)
+            strncat(text, coefficient < 0 ? " - " : " + ", size - strlen(text) - 1);
+        else if (coefficient < 0)
+            strncat(text, "-", size - strlen(text) - 1);
+
+        if (magnitude != 1 || d == 0)
+            AppendNumber(text, size, "%.4g", magnitude);
+
+        if (d > 1)
+            AppendNumber(text, size, "t^%.0f", d);
+        else if (d == 1)
+            strncat(text, "t", size - strlen(text) - 1);
+    }
+}
+
+// Escreve até ANL_VECTORS_SHOWN vetores de tal tamanho (por exemplo "(1, -2, 1) (0, 1, 0)")
+void DescribeVectors(const double *vectors, int count, int length, char *text, size_t size)
+{
+    text[0] = '\0';
+
+    if (count == 0)
+    {
+        strncat(text, "{}", size - 1);
+        return;
+    }
+
+    for (int k = 0; k < count && k < ANL_VECTORS_SHOWN && strlen(text) + 1 < size; k++)
+    {
+        strncat(text, k > 0 ? " (" : "(", size - strlen(text) - 1);
+
+        for (int i = 0; i < length; i++)
+        {
+            // O zero negativo dos vetores do núcleo é exibido como zero
+            double value = vectors[(size_t)k * length + i] + 0.0;
+
+            AppendNumber(text, size, i > 0 ? ", %.4g" : "%.4g", value);
+        }
+
+        strncat(text, ")", size - strlen(text) - 1);
+    }
+
+    if (count > ANL_VECTORS_SHOWN)
+        strncat(text, " ...", size - strlen(text) - 1);
+}
+
+#endif
@@ -23,4 +23,42 @@ float TextLength(const char *text)
     return strlen(text) * 8;
 }
 
+// Corta o texto para que caiba em tal largura, terminando em "..." quando cortado
+void FitText(char *text, float width)
+{
+    if (TextLength(text) <= width)
+        return;
+
+    int length = (int)(width / TextLength("x")) - 3;
+
+    if (length < 0)
+        length = 0;
+
+    strcpy(text + length, "...");
+}
+
+// Restringe o desenho ao retângulo (em coordenadas da canvas) até a chamada de Unclip
+void ClipRect(float x1, float y1, float x2, float y2)
+{
+    float left = x1 < x2 ? x1 : x2;
+    float width = fabsf(x2 - x1);
+    float height = fabsf(y2 - y1);
+
+    // O recorte do OpenGL é feito em pixels da janela, com o y crescendo para cima
+#if Y_CANVAS_CRESCE_PARA_CIMA == TRUE
+    float bottom = y1 < y2 ? y1 : y2;
+#else
+    float bottom = glutGet(GLUT_WINDOW_HEIGHT) - (y1 > y2 ? y1 : y2);
+#endif
+
+    glScissor((int)floorf(left), (int)floorf(bottom), (int)ceilf(width), (int)ceilf(height));
+    glEnable(GL_SCISSOR_TEST);
+}
+
+// Volta a permitir o desenho em toda a janela
+void Unclip()
+{
+    glDisable(GL_SCISSOR_TEST);
+}
+
 #endif
@@ -0,0 +1,537 @@
+/*********************************************************************
+// BigInt.h
+// Implementação de inteiros com sinal de tamanho arbitrário. Os valores
+// são armazenados em magnitude e sinal, com palavras de 32 bits da menos
+// significativa para a mais significativa. Suporta apenas as operações
+// necessárias para a reconstrução de resultados exatos e para a eliminação
+// exata de Rational.h (produto, soma, divisão exata e mdc).
+// *********************************************************************/
+
+#ifndef BIGINT_H
+#define BIGINT_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+    int sign;
+    int length, capacity;
+
+    uint32_t *limbs;
+} BigInt;
+
+// Inicializa o inteiro com o valor zero
+void InitializeBigInt(BigInt *number)
+{
+    number->sign = 0;
+    number->length = 0;
+    number->capacity = 0;
+    number->limbs = NULL;
+}
+
+// Libera a memória ocupada pelo inteiro
+void FreeBigInt(BigInt *number)
+{
+    free(number->limbs);
+    InitializeBigInt(number);
+}
+
+// Garante espaço para pelo menos tal número de palavras
+void ReserveBigInt(BigInt *number, int capacity)
+{
+    if (number->capacity >= capacity)
+        return;
+
+    if (capacity < 2 * number->capacity)
+        capacity = 2 * number->capacity;
+
+    number->limbs = (uint32_t *)realloc(number->limbs, capacity * sizeof(uint32_t));
+    number->capacity = capacity;
+}
+
+// Remove as palavras nulas mais significativas
+void TrimBigInt(BigInt *number)
+{
+    while (number->length > 0 && number->limbs[number->length - 1] == 0)
+        number->length--;
+
+    if (number->length == 0)
+        number->sign = 0;
+}
+
+// Define o valor do inteiro a partir de um inteiro de 64 bits sem sinal
+void SetBigIntUnsigned(BigInt *number, uint64_t value)
+{
+    ReserveBigInt(number, 2);
+
+    number->limbs[0] = (uint32_t)value;
+    number->limbs[1] = (uint32_t)(value >> 32);
+
+    number->length = 2;
+    number->sign = 1;
+
+    TrimBigInt(number);
+}
+
+// Define o valor do inteiro a partir de um inteiro de 64 bits com sinal
+void SetBigInt(BigInt *number, int64_t value)
+{
+    SetBigIntUnsigned(number, value < 0 ? 0 - (uint64_t)value : (uint64_t)value);
+
+    if (value < 0)
+        number->sign = -1;
+}
+
+// Copia o valor de um inteiro para outro
+void CopyBigInt(BigInt *destination, const BigInt *source)
+{
+    ReserveBigInt(destination, source->length);
+    memcpy(destination->limbs, source->limbs, source->length * sizeof(uint32_t));
+
+    destination->length = source->length;
+    destination->sign = source->sign;
+}
+
+// Compara as magnitudes de dois inteiros (-1, 0 ou 1)
+int CompareBigIntMagnitude(const BigInt *a, const BigInt *b)
+{
+    if (a->length != b->length)
+        return a->length < b->length ? -1 : 1;
+
+    for (int i = a->length - 1; i >= 0; i--)
+    {
+        if (a->limbs[i] != b->limbs[i])
+            return a->limbs[i] < b->limbs[i] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+// Multiplica o inteiro por um fator de 64 bits e soma uma parcela de 64 bits
+void MultiplyAddBigInt(BigInt *number, uint64_t factor, uint64_t addend)
+{
+    ReserveBigInt(number, number->length + 4);
+
+    unsigned __int128 carry = addend;
+
+    for (int i = 0; i < number->length; i++)
+    {
+        carry += (unsigned __int128)number->limbs[i] * factor;
+
+        number->limbs[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+
+    while (carry != 0)
+    {
+        number->limbs[number->length++] = (uint32_t)carry;
+        carry >>= 32;
+    }
+
+    if (number->sign == 0)
+        number->sign = 1;
+
+    TrimBigInt(number);
+}
+
+// Subtrai a magnitude de b da magnitude de a (exige |a| >= |b|)
+void SubtractBigIntMagnitude(BigInt *a, const BigInt *b)
+{
+    int64_t borrow = 0;
+
+    for (int i = 0; i < a->length; i++)
+    {
+        int64_t difference = (int64_t)a->limbs[i] - borrow;
+
+        if (i < b->length)
+            difference -= b->limbs[i];
+
+        borrow = difference < 0;
+        a->limbs[i] = (uint32_t)(difference + (borrow << 32));
+    }
+
+    TrimBigInt(a);
+}
+
+// Soma a magnitude de b à magnitude de a
+void AddBigIntMagnitude(BigInt *a, const BigInt *b)
+{
+    int length = a->length > b->length ? a->length : b->length;
+
+    ReserveBigInt(a, length + 1);
+
+    uint64_t carry = 0;
+
+    for (int i = 0; i < length; i++)
+    {
+        carry += i < a->length ? a->limbs[i] : 0;
+        carry += i < b->length ? b->limbs[i] : 0;
+
+        a->limbs[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+
+    a->limbs[length] = (uint32_t)carry;
+    a->length = length + 1;
+
+    TrimBigInt(a);
+}
+
+// Soma a um inteiro outro inteiro multiplicado por factor (1 ou -1)
+void AccumulateBigInt(BigInt *a, const BigInt *b, int factor)
+{
+    int sign = b->sign * factor;
+
+    if (sign == 0)
+        return;
+
+    if (a->sign == 0)
+    {
+        CopyBigInt(a, b);
+        a->sign = sign;
+    }
+    else if (a->sign == sign)
+    {
+        AddBigIntMagnitude(a, b);
+    }
+    else if (CompareBigIntMagnitude(a, b) >= 0)
+    {
+        SubtractBigIntMagnitude(a, b);
+    }
+    else
+    {
+        // |b| > |a|: o resultado é |b| - |a| com o sinal da parcela somada
+        BigInt difference;
+        InitializeBigInt(&difference);
+
+        CopyBigInt(&difference, b);
+        SubtractBigIntMagnitude(&difference, a);
+        difference.sign = sign;
+
+        FreeBigInt(a);
+        *a = difference;
+    }
+}
+
+// Multiplica dois inteiros (product deve ser diferente de a e de b)
+void MultiplyBigInt(BigInt *product, const BigInt *a, const BigInt *b)
+{
+    if (a->sign == 0 || b->sign == 0)
+    {
+        product->length = 0;
+        product->sign = 0;
+        return;
+    }
+
+    int length = a->length + b->length;
+
+    ReserveBigInt(product, length);
+    memset(product->limbs, 0, length * sizeof(uint32_t));
+
+    for (int i = 0; i < a->length; i++)
+    {
+        uint64_t carry = 0;
+
+        for (int j = 0; j < b->length; j++)
+        {
+            carry += (uint64_t)a->limbs[i] * b->limbs[j] + product->limbs[i + j];
+
+            product->limbs[i + j] = (uint32_t)carry;
+            carry >>= 32;
+        }
+
+        product->limbs[i + b->length] = (uint32_t)carry;
+    }
+
+    product->length = length;
+    product->sign = a->sign * b->sign;
+
+    TrimBigInt(product);
+}
+
+// Conta os bits nulos menos significativos de um inteiro diferente de zero
+int TrailingZerosBigInt(const BigInt *number)
+{
+    int i = 0;
+
+    while (number->limbs[i] == 0)
+        i++;
+
+    return 32 * i + __builtin_ctz(number->limbs[i]);
+}
+
+// Desloca a magnitude do inteiro tal quantidade de bits para a direita
+void ShiftBigIntRight(BigInt *number, int bits)
+{
+    int words = bits / 32;
+    int shift = bits % 32;
+
+    if (words >= number->length)
+    {
+        number->length = 0;
+        number->sign = 0;
+        return;
+    }
+
+    for (int i = 0; i + words < number->length; i++)
+    {
+        uint64_t value = number->limbs[i + words];
+
+        if (i + words + 1 < number->length)
+            value |= (uint64_t)number->limbs[i + words + 1] << 32;
+
+        number->limbs[i] = (uint32_t)(value >> shift);
+    }
+
+    number->length -= words;
+
+    TrimBigInt(number);
+}
+
+// Divide a por b quando a divisão é exata (quotient deve ser diferente de a e de b)
+// Sem os bits nulos em comum, b fica ímpar e cada palavra do quociente sai da palavra
+// menos significativa do resto multiplicada pelo inverso de b módulo 2^32
+void DivideBigIntExact(BigInt *quotient, const BigInt *a, const BigInt *b)
+{
+    BigInt dividend, divisor;
+
+    InitializeBigInt(&dividend);
+    InitializeBigInt(&divisor);
+
+    CopyBigInt(&dividend, a);
+    CopyBigInt(&divisor, b);
+
+    int zeros = TrailingZerosBigInt(&divisor);
+
+    ShiftBigIntRight(&dividend, zeros);
+    ShiftBigIntRight(&divisor, zeros);
+
+    int length = dividend.length - divisor.length + 1;
+
+    if (dividend.sign == 0 || length <= 0)
+    {
+        quotient->length = 0;
+        quotient->sign = 0;
+
+        FreeBigInt(&dividend);
+        FreeBigInt(&divisor);
+        return;
+    }
+
+    // Cada iteração de Newton dobra os bits corretos do inverso (3 bits corretos de início)
+    uint32_t low = divisor.limbs[0];
+    uint32_t inverse = low;
+
+    for (int k = 0; k < 4; k++)
+        inverse *= 2 - low * inverse;
+
+    ReserveBigInt(quotient, length);
+
+    for (int i = 0; i < length; i++)
+    {
+        uint32_t digit = dividend.limbs[i] * inverse;
+        quotient->limbs[i] = digit;
+
+        // Subtrai digit * divisor da posição i em diante (o resto parcial nunca fica negativo)
+        uint64_t carry = 0;
+        int64_t borrow = 0;
+
+        for (int k = i; k < dividend.length; k++)
+        {
+            int j = k - i;
+
+            if (j >= divisor.length && carry == 0 && borrow == 0)
+                break;
+
+            carry += j < divisor.length ? (uint64_t)digit * divisor.limbs[j] : 0;
+
+            int64_t difference = (int64_t)dividend.limbs[k] - (int64_t)(uint32_t)carry - borrow;
+
+            borrow = difference < 0;
+            dividend.limbs[k] = (uint32_t)(difference + (borrow << 32));
+            carry >>= 32;
+        }
+    }
+
+    quotient->length = length;
+    quotient->sign = a->sign * b->sign;
+
+    TrimBigInt(quotient);
+
+    FreeBigInt(&dividend);
+    FreeBigInt(&divisor);
+}
+
+// Calcula o máximo divisor comum (positivo) das magnitudes de dois inteiros pelo algoritmo binário
+void GreatestCommonDivisorBigInt(BigInt *divisor, const BigInt *a, const BigInt *b)
+{
+    if (a->sign == 0 || b->sign == 0)
+    {
+        CopyBigInt(divisor, a->sign == 0 ? b : a);
+
+        if (divisor->sign != 0)
+            divisor->sign = 1;
+
+        return;
+    }
+
+    BigInt u, v;
+
+    InitializeBigInt(&u);
+    InitializeBigInt(&v);
+
+    CopyBigInt(&u, a);
+    CopyBigInt(&v, b);
+
+    u.sign = 1;
+    v.sign = 1;
+
+    int zerosU = TrailingZerosBigInt(&u);
+    int zerosV = TrailingZerosBigInt(&v);
+    int shift = zerosU < zerosV ? zerosU : zerosV;
+
+    ShiftBigIntRight(&u, zerosU);
+
+    while (v.sign != 0)
+    {
+        ShiftBigIntRight(&v, TrailingZerosBigInt(&v));
+
+        if (CompareBigIntMagnitude(&u, &v) > 0)
+        {
+            BigInt temp = u;
+            u = v;
+            v = temp;
+        }
+
+        SubtractBigIntMagnitude(&v, &u);
+    }
+
+    for (; shift > 0; shift -= 32)
+        MultiplyAddBigInt(&u, (uint64_t)1 << (shift < 32 ? shift : 32), 0);
+
+    CopyBigInt(divisor, &u);
+
+    FreeBigInt(&u);
+    FreeBigInt(&v);
+}
+
+// Converte o inteiro para 64 bits com sinal, retornando falso caso ele não caiba
+bool BigIntToInt64(const BigInt *number, int64_t *value)
+{
+    if (number->length > 2)
+        return false;
+
+    uint64_t magnitude = 0;
+
+    for (int i = number->length - 1; i >= 0; i--)
+        magnitude = (magnitude << 32) | number->limbs[i];
+
+    if (magnitude > (uint64_t)INT64_MAX)
+        return false;
+
+    *value = number->sign < 0 ? -(int64_t)magnitude : (int64_t)magnitude;
+
+    return true;
+}
+
+// Retorna a divisão a / b em double, a partir das três palavras mais significativas de cada inteiro
+double BigIntRatio(const BigInt *a, const BigInt *b)
+{
+    double top[2] = {0, 0};
+    int skipped[2];
+
+    const BigInt *numbers[2] = {a, b};
+
+    for (int k = 0; k < 2; k++)
+    {
+        skipped[k] = numbers[k]->length > 3 ? numbers[k]->length - 3 : 0;
+
+        for (int i = numbers[k]->length - 1; i >= skipped[k]; i--)
+            top[k] = top[k] * 4294967296.0 + numbers[k]->limbs[i];
+    }
+
+    return a->sign * b->sign * ldexp(top[0] / top[1], 32 * (skipped[0] - skipped[1]));
+}
+
+// Divide a magnitude do inteiro por um divisor de 32 bits e retorna o resto
+uint32_t DivideBigIntSmall(BigInt *number, uint32_t divisor)
+{
+    uint64_t remainder = 0;
+
+    for (int i = number->length - 1; i >= 0; i--)
+    {
+        uint64_t current = (remainder << 32) | number->limbs[i];
+
+        number->limbs[i] = (uint32_t)(current / divisor);
+        remainder = current % divisor;
+    }
+
+    TrimBigInt(number);
+
+    return (uint32_t)remainder;
+}
+
+// Imprime o inteiro em base decimal no texto de destino
+// Retorna falso caso o texto não caiba no espaço disponível
+bool PrintBigInt(const BigInt *number, char *destination, int capacity)
+{
+    if (number->sign == 0)
+    {
+        if (capacity < 2)
+            return false;
+
+        strcpy(destination, "0");
+        return true;
+    }
+
+    BigInt quotient;
+    InitializeBigInt(&quotient);
+    CopyBigInt(&quotient, number);
+
+    // Extrai 9 dígitos decimais por divisão
+    int length = 0;
+
+    while (quotient.length > 0)
+    {
+        uint32_t chunk = DivideBigIntSmall(&quotient, 1000000000);
+
+        for (int k = 0; k < 9 && (quotient.length > 0 || chunk != 0); k++)
+        {
+            if (length + 2 > capacity)
+            {
+                FreeBigInt(&quotient);
+                return false;
+            }
+
+            destination[length++] = '0' + chunk % 10;
+            chunk /= 10;
+        }
+    }
+
+    FreeBigInt(&quotient);
+
+    if (number->sign < 0)
+    {
+        if (length + 2 > capacity)
+            return false;
+
+        destination[length++] = '-';
+    }
+
+    destination[length] = '\0';
+
+    for (int i = 0, j = length - 1; i < j; i++, j--)
+    {
+        char temp = destination[i];
+
+        destination[i] = destination[j];
+        destination[j] = temp;
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,377 @@
+/*********************************************************************
+// Complex.h
+// Rotinas numéricas sobre matrizes complexas com as partes real e
+// imaginária em arrays separados de double, linha por linha. Assim os
+// laços internos operam sobre doubles consecutivos, como os de Dense.h,
+// e são vetorizados pelo compilador sem intercalar as duas partes.
+// *********************************************************************/
+
+#ifndef COMPLEX_H
+#define COMPLEX_H
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Dense.h"
+#include "Task.h"
+
+// Menor dimensão interna em que o produto usa 3 multiplicações reais em
+// vez de 4: abaixo dela, as somas extras custam mais do que a economia
+#define CPX_3M_MIN_SIZE 64
+
+// Divide (ar + ai i) por (br + bi i) pelo método de Smith, que evita o
+// overflow de br² + bi² quando o divisor é muito grande ou muito pequeno
+void ComplexDivide(double ar, double ai, double br, double bi, double *real, double *imaginary)
+{
+    if (fabs(br) >= fabs(bi))
+    {
+        double ratio = bi / br;
+        double denominator = br + bi * ratio;
+
+        *real = (ar + ai * ratio) / denominator;
+        *imaginary = (ai - ar * ratio) / denominator;
+    }
+    else
+    {
+        double ratio = br / bi;
+        double denominator = br * ratio + bi;
+
+        *real = (ar * ratio + ai) / denominator;
+        *imaginary = (ai * ratio - ar) / denominator;
+    }
+}
+
+// Módulo aproximado |re| + |im|, suficiente para escolher pivôs
+double ComplexMagnitude(double real, double imaginary)
+{
+    return fabs(real) + fabs(imaginary);
+}
+
+// Multiplica x (rows x size) por y (size x columns), ambas complexas
+// Com size >= CPX_3M_MIN_SIZE usa o método 3M:
+//   t1 = xr * yr, t2 = xi * yi, t3 = (xr + xi) * (yr + yi)
+//   zr = t1 - t2, zi = t3 - t1 - t2
+// e nos demais casos as 4 multiplicações reais do produto direto
+// O resultado não pode compartilhar memória com as entradas
+void ComplexMultiply(const double *xr, const double *xi, const double *yr, const double *yi, double *zr, double *zi, int rows, int size, int columns, Task *task = NULL)
+{
+    size_t countX = (size_t)rows * size;
+    size_t countY = (size_t)size * columns;
+    size_t countZ = (size_t)rows * columns;
+
+    float first = task != NULL ? task->first : 0;
+    float last = task != NULL ? task->last : 1;
+
+    double *temp = (double *)malloc((countZ + 1) * sizeof(double));
+
+    // As partes de y são transpostas uma vez e lidas linha por linha por todos os produtos
+    double *yrt = (double *)malloc((countY + 1) * sizeof(double));
+    double *yit = (double *)malloc((countY + 1) * sizeof(double));
+
+    DenseTranspose(yr, yrt, size, columns);
+    DenseTranspose(yi, yit, size, columns);
+
+    if (size >= CPX_3M_MIN_SIZE)
+    {
+        double *sumX = (double *)malloc((countX + 1) * sizeof(double));
+        double *sumY = (double *)malloc((countY + 1) * sizeof(double));
+
+        for (size_t k = 0; k < countX; k++)
+            sumX[k] = xr[k] + xi[k];
+
+        for (size_t k = 0; k < countY; k++)
+            sumY[k] = yrt[k] + yit[k];
+
+        SetTaskStage(task, first, first + (last - first) / 3);
+        DenseMultiplyTransposed(xr, yrt, zr, rows, size, columns, task);
+
+        SetTaskStage(task, first + (last - first) / 3, first + (last - first) * 2 / 3);
+        DenseMultiplyTransposed(xi, yit, temp, rows, size, columns, task);
+
+        SetTaskStage(task, first + (last - first) * 2 / 3, last);
+        DenseMultiplyTransposed(sumX, sumY, zi, rows, size, columns, task);
+
+        for (size_t k = 0; k < countZ; k++)
+        {
+            zi[k] -= zr[k] + temp[k];
+            zr[k] -= temp[k];
+        }
+
+        free(sumX);
+        free(sumY);
+    }
+    else
+    {
+        SetTaskStage(task, first, first + (last - first) / 4);
+        DenseMultiplyTransposed(xr, yrt, zr, rows, size, columns, task);
+
+        SetTaskStage(task, first + (last - first) / 4, first + (last - first) / 2);
+        DenseMultiplyTransposed(xi, yit, temp, rows, size, columns, task);
+
+        for (size_t k = 0; k < countZ; k++)
+            zr[k] -= temp[k];
+
+        SetTaskStage(task, first + (last - first) / 2, first + (last - first) * 3 / 4);
+        DenseMultiplyTransposed(xr, yit, zi, rows, size, columns, task);
+
+        SetTaskStage(task, first + (last - first) * 3 / 4, last);
+        DenseMultiplyTransposed(xi, yrt, temp, rows, size, columns, task);
+
+        for (size_t k = 0; k < countZ; k++)
+            zi[k] += temp[k];
+    }
+
+    free(yrt);
+    free(yit);
+    free(temp);
+}
+
+// Troca duas linhas de uma matriz complexa com tal quantidade de colunas
+void ComplexSwapRows(double *ar, double *ai, int columns, int i1, int i2)
+{
+    double *parts[2] = {ar, ai};
+
+    for (int p = 0; p < 2; p++)
+    {
+        double *row1 = parts[p] + (size_t)i1 * columns;
+        double *row2 = parts[p] + (size_t)i2 * columns;
+
+        for (int j = 0; j < columns; j++)
+        {
+            double temp = row1[j];
+
+            row1[j] = row2[j];
+            row2[j] = temp;
+        }
+    }
+}
+
+// Subtrai (cr + ci i) vezes a linha source da linha target nas colunas [first, columns)
+void ComplexEliminateRow(double *ar, double *ai, int columns, int target, int source, double cr, double ci, int first)
+{
+    double *targetR = ar + (size_t)target * columns;
+    double *targetI = ai + (size_t)target * columns;
+    const double *sourceR = ar + (size_t)source * columns;
+    const double *sourceI = ai + (size_t)source * columns;
+
+    for (int j = first; j < columns; j++)
+    {
+        double real = cr * sourceR[j] - ci * sourceI[j];
+        double imaginary = cr * sourceI[j] + ci * sourceR[j];
+
+        targetR[j] -= real;
+        targetI[j] -= imaginary;
+    }
+}
+
+// Fatoração LU com pivoteamento parcial da matriz complexa quadrada a, no
+// próprio lugar (L com diagonal unitária implícita abaixo da diagonal e U
+// acima), sendo pivots[k] a linha trocada com a linha k
+// Retorna o sinal da permutação ou 0 caso a matriz seja singular
+int ComplexFactorLU(double *ar, double *ai, int *pivots, int size)
+{
+    int signal = 1;
+
+    for (int k = 0; k < size; k++)
+    {
+        int pivot = k;
+        double largest = ComplexMagnitude(ar[(size_t)k * size + k], ai[(size_t)k * size + k]);
+
+        for (int i = k + 1; i < size; i++)
+        {
+            double magnitude = ComplexMagnitude(ar[(size_t)i * size + k], ai[(size_t)i * size + k]);
+
+            if (magnitude > largest)
+            {
+                pivot = i;
+                largest = magnitude;
+            }
+        }
+
+        pivots[k] = pivot;
+
+        if (largest == 0)
+            return 0;
+
+        if (pivot != k)
+        {
+            ComplexSwapRows(ar, ai, size, k, pivot);
+            signal = -signal;
+        }
+
+        double pr = ar[(size_t)k * size + k];
+        double pi = ai[(size_t)k * size + k];
+
+        for (int i = k + 1; i < size; i++)
+        {
+            double cr, ci;
+            ComplexDivide(ar[(size_t)i * size + k], ai[(size_t)i * size + k], pr, pi, &cr, &ci);
+
+            ar[(size_t)i * size + k] = cr;
+            ai[(size_t)i * size + k] = ci;
+
+            ComplexEliminateRow(ar, ai, size, i, k, cr, ci, k + 1);
+        }
+    }
+
+    return signal;
+}
+
+// Calcula o determinante da matriz complexa quadrada a pela fatoração LU
+void ComplexDeterminant(const double *ar, const double *ai, int size, double *real, double *imaginary)
+{
+    size_t count = (size_t)size * size;
+
+    double *lr = (double *)malloc((count + 1) * sizeof(double));
+    double *li = (double *)malloc((count + 1) * sizeof(double));
+    int *pivots = (int *)malloc((size + 1) * sizeof(int));
+
+    memcpy(lr, ar, count * sizeof(double));
+    memcpy(li, ai, count * sizeof(double));
+
+    double dr = ComplexFactorLU(lr, li, pivots, size);
+    double di = 0;
+
+    for (int k = 0; k < size && dr != 0; k++)
+    {
+        double ur = lr[(size_t)k * size + k];
+        double ui = li[(size_t)k * size + k];
+
+        double temp = dr * ur - di * ui;
+        di = dr * ui + di * ur;
+        dr = temp;
+    }
+
+    *real = dr;
+    *imaginary = di;
+
+    free(lr);
+    free(li);
+    free(pivots);
+}
+
+// Resolve o sistema complexo a * x = b, sendo a quadrada de ordem size e b
+// com columns colunas, pela fatoração LU com pivoteamento parcial
+// Retorna falso caso a matriz seja singular
+bool ComplexSolve(const double *ar, const double *ai, const double *br, const double *bi, double *xr, double *xi, int size, int columns)
+{
+    size_t count = (size_t)size * size;
+
+    double *lr = (double *)malloc((count + 1) * sizeof(double));
+    double *li = (double *)malloc((count + 1) * sizeof(double));
+    int *pivots = (int *)malloc((size + 1) * sizeof(int));
+
+    memcpy(lr, ar, count * sizeof(double));
+    memcpy(li, ai, count * sizeof(double));
+    memcpy(xr, br, (size_t)size * columns * sizeof(double));
+    memcpy(xi, bi, (size_t)size * columns * sizeof(double));
+
+    bool regular = ComplexFactorLU(lr, li, pivots, size) != 0;
+
+    if (regular)
+    {
+        for (int k = 0; k < size; k++)
+        {
+            if (pivots[k] != k)
+                ComplexSwapRows(xr, xi, columns, k, pivots[k]);
+        }
+
+        // As linhas de x são combinadas inteiras, com os coeficientes de L e de U
+        for (int i = 0; i < size; i++)
+        {
+            for (int k = 0; k < i; k++)
+                ComplexEliminateRow(xr, xi, columns, i, k, lr[(size_t)i * size + k], li[(size_t)i * size + k], 0);
+        }
+
+        for (int i = size - 1; i >= 0; i--)
+        {
+            for (int k = i + 1; k < size; k++)
+                ComplexEliminateRow(xr, xi, columns, i, k, lr[(size_t)i * size + k], li[(size_t)i * size + k], 0);
+
+            double ur = lr[(size_t)i * size + i];
+            double ui = li[(size_t)i * size + i];
+
+            for (int j = 0; j < columns; j++)
+                ComplexDivide(xr[(size_t)i * columns + j], xi[(size_t)i * columns + j], ur, ui, &xr[(size_t)i * columns + j], &xi[(size_t)i * columns + j]);
+        }
+    }
+
+    free(lr);
+    free(li);
+    free(pivots);
+
+    return regular;
+}
+
+// Reduz a matriz complexa z à forma escalonada reduzida por linhas, com
+// pivoteamento parcial em cada coluna. Colunas cujos candidatos a pivô
+// não passam de tolerance (em |re| + |im|) são consideradas nulas
+// Retorna o posto encontrado
+int ComplexReduce(double *zr, double *zi, int rows, int columns, double tolerance, Task *task = NULL)
+{
+    int rank = 0;
+
+    for (int j = 0; j < columns && rank < rows && !IsTaskCancelled(task); j++)
+    {
+        int pivot = rank;
+        double largest = ComplexMagnitude(zr[(size_t)rank * columns + j], zi[(size_t)rank * columns + j]);
+
+        for (int i = rank + 1; i < rows; i++)
+        {
+            double magnitude = ComplexMagnitude(zr[(size_t)i * columns + j], zi[(size_t)i * columns + j]);
+
+            if (magnitude > largest)
+            {
+                pivot = i;
+                largest = magnitude;
+            }
+        }
+
+        if (largest <= tolerance)
+            continue;
+
+        if (pivot != rank)
+            ComplexSwapRows(zr, zi, columns, rank, pivot);
+
+        // A linha do pivô é dividida por ele, que passa a valer exatamente 1
+        double *rowR = zr + (size_t)rank * columns;
+        double *rowI = zi + (size_t)rank * columns;
+
+        double inverseR, inverseI;
+        ComplexDivide(1, 0, rowR[j], rowI[j], &inverseR, &inverseI);
+
+        for (int k = j; k < columns; k++)
+        {
+            double real = rowR[k] * inverseR - rowI[k] * inverseI;
+
+            rowI[k] = rowR[k] * inverseI + rowI[k] * inverseR;
+            rowR[k] = real;
+        }
+
+        rowR[j] = 1;
+        rowI[j] = 0;
+
+        for (int i = 0; i < rows; i++)
+        {
+            double cr = zr[(size_t)i * columns + j];
+            double ci = zi[(size_t)i * columns + j];
+
+            if (i != rank && (cr != 0 || ci != 0))
+            {
+                ComplexEliminateRow(zr, zi, columns, i, rank, cr, ci, j);
+
+                zr[(size_t)i * columns + j] = 0;
+                zi[(size_t)i * columns + j] = 0;
+            }
+        }
+
+        rank++;
+
+        SetTaskProgress(task, (float)rank / rows);
+    }
+
+    return rank;
+}
+
+#endif
@@ -0,0 +1,803 @@
+/*********************************************************************
+// Dense.h
+// Rotinas numéricas sobre arrays densos de double armazenados linha por
+// linha. Independem da interface e aceitam matrizes de qualquer tamanho.
+// *********************************************************************/
+
+#ifndef DENSE_H
+#define DENSE_H
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Parallel.h"
+#include "Random.h"
+#include "Task.h"
+
+// Tamanho dos blocos em que a recursão da transposta é interrompida
+#define DNS_TILE 16
+
+// Tamanho dos blocos da multiplicação (3 blocos de 64 x 64 doubles cabem na cache L2)
+#define DNS_BLOCK 64
+
+// Largura dos painéis e dos blocos atualizados pela fatoração LU
+#define DNS_LU_BLOCK 96
+
+// Grau do aproximante de Padé usado na exponencial
+#define DNS_PADE_DEGREE 6
+
+// Quantidade máxima de vetores da verificação de Freivalds (um bit aleatório por vetor)
+#define DNS_FREIVALDS_MAX_TRIALS 64
+
+// Transpõe um bloco rows x columns de a (com passo lda) para b (com passo ldb)
+// dividindo sempre a maior dimensão ao meio, sem depender do tamanho da cache
+void DenseTransposeBlock(const double *a, int lda, double *b, int ldb, int rows, int columns)
+{
+    if (rows <= DNS_TILE && columns <= DNS_TILE)
+    {
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = 0; j < columns; j++)
+            {
+                b[j * ldb + i] = a[i * lda + j];
+            }
+        }
+    }
+    else if (rows >= columns)
+    {
+        int half = rows / 2;
+
+        DenseTransposeBlock(a, lda, b, ldb, half, columns);
+        DenseTransposeBlock(a + half * lda, lda, b + half, ldb, rows - half, columns);
+    }
+    else
+    {
+        int half = columns / 2;
+
+        DenseTransposeBlock(a, lda, b, ldb, rows, half);
+        DenseTransposeBlock(a + half, lda, b + half * ldb, ldb, rows, columns - half);
+    }
+}
+
+// Troca um bloco rows x columns de a pela transposta do bloco columns x rows de b
+void DenseSwapTransposedBlock(double *a, double *b, int stride, int rows, int columns)
+{
+    if (rows <= DNS_TILE && columns <= DNS_TILE)
+    {
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = 0; j < columns; j++)
+            {
+                double temp = a[i * stride + j];
+
+                a[i * stride + j] = b[j * stride + i];
+                b[j * stride + i] = temp;
+            }
+        }
+    }
+    else if (rows >= columns)
+    {
+        int half = rows / 2;
+
+        DenseSwapTransposedBlock(a, b, stride, half, columns);
+        DenseSwapTransposedBlock(a + half * stride, b + half, stride, rows - half, columns);
+    }
+    else
+    {
+        int half = columns / 2;
+
+        DenseSwapTransposedBlock(a, b, stride, rows, half);
+        DenseSwapTransposedBlock(a + half, b + half * stride, stride, rows, columns - half);
+    }
+}
+
+// Transpõe no próprio lugar um bloco quadrado de a com passo stride
+void DenseTransposeSquare(double *a, int stride, int size)
+{
+    if (size <= DNS_TILE)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            for (int j = i + 1; j < size; j++)
+            {
+                double temp = a[i * stride + j];
+
+                a[i * stride + j] = a[j * stride + i];
+                a[j * stride + i] = temp;
+            }
+        }
+
+        return;
+    }
+
+    int half = size / 2;
+
+    DenseTransposeSquare(a, stride, half);
+    DenseTransposeSquare(a + half * stride + half, stride, size - half);
+    DenseSwapTransposedBlock(a + half, a + half * stride, stride, half, size - half);
+}
+
+// Transpõe a matriz a (rows x columns) para b (columns x rows)
+// Caso a e b sejam o mesmo array, a matriz deve ser quadrada
+void DenseTranspose(const double *a, double *b, int rows, int columns)
+{
+    if (a == b)
+        DenseTransposeSquare(b, columns, rows);
+    else
+        DenseTransposeBlock(a, columns, b, rows, rows, columns);
+}
+
+// Multiplica x (rows x size) pela transposta de yt (columns x size), ou seja, z = x * yt^T
+// Ambos os operandos são lidos linha por linha: cada elemento de z é o produto escalar de
+// uma linha de x por uma linha de yt, calculados em grupos de 2 x 4 com acumuladores
+// independentes, e as linhas de yt de uma faixa de DNS_BLOCK colunas continuam na cache
+// O resultado z não pode compartilhar memória com x ou yt
+void DenseMultiplyTransposed(const double *x, const double *yt, double *z, int rows, int size, int columns, Task *task = NULL)
+{
+    for (int j0 = 0; j0 < columns && !IsTaskCancelled(task); j0 += DNS_BLOCK)
+    {
+        int j1 = j0 + DNS_BLOCK < columns ? j0 + DNS_BLOCK : columns;
+
+        for (int i = 0; i < rows; i += 2)
+        {
+            // Uma última linha sem par é calculada duas vezes e escrita uma vez
+            const double *a0 = x + (size_t)i * size;
+            const double *a1 = i + 1 < rows ? a0 + size : a0;
+
+            for (int j = j0; j < j1; j += 4)
+            {
+                const double *b0 = yt + (size_t)j * size;
+                const double *b1 = j + 1 < j1 ? b0 + size : b0;
+                const double *b2 = j + 2 < j1 ? b0 + 2 * (size_t)size : b0;
+                const double *b3 = j + 3 < j1 ? b0 + 3 * (size_t)size : b0;
+
+                double s00 = 0, s01 = 0, s02 = 0, s03 = 0;
+                double s10 = 0, s11 = 0, s12 = 0, s13 = 0;
+
+                for (int k = 0; k < size; k++)
+                {
+                    double v0 = a0[k], v1 = a1[k];
+
+                    s00 += v0 * b0[k];
+                    s01 += v0 * b1[k];
+                    s02 += v0 * b2[k];
+                    s03 += v0 * b3[k];
+
+                    s10 += v1 * b0[k];
+                    s11 += v1 * b1[k];
+                    s12 += v1 * b2[k];
+                    s13 += v1 * b3[k];
+                }
+
+                double sums[2][4] = {{s00, s01, s02, s03}, {s10, s11, s12, s13}};
+
+                for (int r = 0; r < 2 && i + r < rows; r++)
+                {
+                    for (int l = 0; l < 4 && j + l < j1; l++)
+                        z[(size_t)(i + r) * columns + j + l] = sums[r][l];
+                }
+            }
+        }
+
+        SetTaskProgress(task, (float)j1 / columns);
+    }
+}
+
+// Multiplica x (rows x size) por y (size x columns) em blocos que cabem na cache
+// As linhas de y e de z são percorridas em sequência e nenhuma memória é alocada
+// O resultado z não pode compartilhar memória com x ou y
+// Com uma tarefa, o cancelamento é verificado a cada faixa de DNS_BLOCK linhas
+void DenseMultiply(const double *x, const double *y, double *z, int rows, int size, int columns, Task *task = NULL)
+{
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < columns; j++)
+        {
+            z[(size_t)i * columns + j] = 0;
+        }
+    }
+
+    for (int i0 = 0; i0 < rows && !IsTaskCancelled(task); i0 += DNS_BLOCK)
+    {
+        int i1 = i0 + DNS_BLOCK < rows ? i0 + DNS_BLOCK : rows;
+
+        for (int k0 = 0; k0 < size; k0 += DNS_BLOCK)
+        {
+            int k1 = k0 + DNS_BLOCK < size ? k0 + DNS_BLOCK : size;
+
+            for (int j0 = 0; j0 < columns; j0 += DNS_BLOCK)
+            {
+                int j1 = j0 + DNS_BLOCK < columns ? j0 + DNS_BLOCK : columns;
+
+                for (int i = i0; i < i1; i++)
+                {
+                    double *row = z + (size_t)i * columns;
+
+                    for (int k = k0; k < k1; k++)
+                    {
+                        double coefficient = x[(size_t)i * size + k];
+                        const double *source = y + (size_t)k * columns;
+
+                        for (int j = j0; j < j1; j++)
+                        {
+                            row[j] += coefficient * source[j];
+                        }
+                    }
+                }
+            }
+        }
+
+        SetTaskProgress(task, (float)i1 / rows);
+    }
+}
+
+// Verificação de Freivalds de z = x * y: multiplica os dois lados por trials vetores
+// aleatórios de ±1, em O(trials * n²) em vez de O(n³), e retorna o maior erro relativo
+// entre x * (y * r) e z * r. Um produto errado passa por cada vetor com chance de no
+// máximo 1/2. O erro de cada elemento é relativo a |x| * |y| * |r| + |z| * |r|, que
+// limita o arredondamento, então um produto correto fica abaixo de (size + columns) * DBL_EPSILON
+// Cada matriz é percorrida uma única vez para todos os vetores
+double DenseFreivalds(const double *x, const double *y, const double *z, int rows, int size, int columns, int trials, Random *random)
+{
+    if (trials < 1)
+        trials = 1;
+
+    if (trials > DNS_FREIVALDS_MAX_TRIALS)
+        trials = DNS_FREIVALDS_MAX_TRIALS;
+
+    // Os vetores lado a lado (vectors[j * trials + t] é o elemento j do vetor t),
+    // para que os laços sobre os vetores sejam contíguos e vetorizáveis
+    double *vectors = (double *)malloc(((size_t)columns * trials + 1) * sizeof(double));
+
+    for (int j = 0; j < columns; j++)
+    {
+        uint64_t signs = NextRandom(random);
+
+        for (int t = 0; t < trials; t++)
+            vectors[(size_t)j * trials + t] = (signs >> t & 1) ? -1.0 : 1.0;
+    }
+
+    // y * r para todos os vetores e |y| * |r| (igual para todos, já que |r| = 1)
+    double *products = (double *)calloc((size_t)size * trials + 1, sizeof(double));
+    double *magnitudes = (double *)malloc(((size_t)size + 1) * sizeof(double));
+
+    for (int k = 0; k < size; k++)
+    {
+        const double *row = y + (size_t)k * columns;
+        double *product = products + (size_t)k * trials;
+
+        double magnitude = 0;
+
+        for (int j = 0; j < columns; j++)
+        {
+            double value = row[j];
+            const double *vector = vectors + (size_t)j * trials;
+
+            magnitude += fabs(value);
+
+            for (int t = 0; t < trials; t++)
+                product[t] += value * vector[t];
+        }
+
+        magnitudes[k] = magnitude;
+    }
+
+    double expected[DNS_FREIVALDS_MAX_TRIALS];
+    double found[DNS_FREIVALDS_MAX_TRIALS];
+
+    double worst = 0;
+
+    for (int i = 0; i < rows; i++)
+    {
+        const double *rowX = x + (size_t)i * size;
+        const double *rowZ = z + (size_t)i * columns;
+
+        double bound = 0;
+
+        for (int t = 0; t < trials; t++)
+        {
+            expected[t] = 0;
+            found[t] = 0;
+        }
+
+        for (int k = 0; k < size; k++)
+        {
+            double value = rowX[k];
+            const double *product = products + (size_t)k * trials;
+
+            bound += fabs(value) * magnitudes[k];
+
+            for (int t = 0; t < trials; t++)
+                expected[t] += value * product[t];
+        }
+
+        for (int j = 0; j < columns; j++)
+        {
+            double value = rowZ[j];
+            const double *vector = vectors + (size_t)j * trials;
+
+            bound += fabs(value);
+
+            for (int t = 0; t < trials; t++)
+                found[t] += value * vector[t];
+        }
+
+        for (int t = 0; t < trials; t++)
+        {
+            double difference = fabs(expected[t] - found[t]);
+            double error = difference == 0 ? 0 : difference / bound;
+
+            // Um NaN em z (ou nas entradas) nunca é aceito
+            if (error != error)
+                error = INFINITY;
+
+            if (error > worst)
+                worst = error;
+        }
+    }
+
+    free(vectors);
+    free(products);
+    free(magnitudes);
+
+    return worst;
+}
+
+// Define a como a matriz identidade de tal ordem
+void DenseIdentity(double *a, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = 0; j < size; j++)
+        {
+            a[(size_t)i * size + j] = i == j;
+        }
+    }
+}
+
+// Eleva a matriz quadrada x ao expoente k por exponenciação binária,
+// com O(log k) multiplicações. Os dois arrays auxiliares (do mesmo tamanho
+// de x) são alternados entre os passos, sem novas alocações
+void DensePower(const double *x, double *z, double *scratchA, double *scratchB, int size, unsigned int k, Task *task = NULL)
+{
+    size_t count = (size_t)size * size;
+
+    // Cada bit do expoente custa até duas multiplicações
+    int steps = 0, step = 0;
+
+    for (unsigned int bits = k; bits > 0; bits >>= 1)
+        steps += 2;
+
+    float first = task != NULL ? task->first : 0;
+    float last = task != NULL ? task->last : 1;
+
+    double *result = z;
+    double *base = scratchA;
+    double *temp = scratchB;
+
+    DenseIdentity(result, size);
+    memcpy(base, x, count * sizeof(double));
+
+    while (k > 0 && !IsTaskCancelled(task))
+    {
+        if (k & 1)
+        {
+            SetTaskStage(task, first + (last - first) * step / steps, first + (last - first) * (step + 1) / steps);
+            DenseMultiply(result, base, temp, size, size, size, task);
+
+            double *swap = result;
+            result = temp;
+            temp = swap;
+        }
+
+        step++;
+        k >>= 1;
+
+        if (k > 0)
+        {
+            SetTaskStage(task, first + (last - first) * step / steps, first + (last - first) * (step + 1) / steps);
+            DenseMultiply(base, base, temp, size, size, size, task);
+
+            double *swap = base;
+            base = temp;
+            temp = swap;
+        }
+
+        step++;
+    }
+
+    if (result != z)
+        memcpy(z, result, count * sizeof(double));
+}
+
+// Fatora as colunas [first, last) de lu (ordem size), das linhas first em
+// diante, com pivoteamento parcial. As trocas de linha ficam restritas
+// às colunas do painel e o resto da matriz não é lido
+// Retorna falso caso alguma coluna não tenha pivô não nulo
+bool DenseFactorPanel(double *lu, int *pivots, int size, int first, int last)
+{
+    bool regular = true;
+
+    for (int k = first; k < last; k++)
+    {
+        int pivot = k;
+
+        for (int i = k + 1; i < size; i++)
+        {
+            if (fabs(lu[(size_t)i * size + k]) > fabs(lu[(size_t)pivot * size + k]))
+                pivot = i;
+        }
+
+        pivots[k] = pivot;
+
+        // Coluna nula: não há o que eliminar e o fator continua utilizável pelo determinante
+        if (lu[(size_t)pivot * size + k] == 0)
+        {
+            regular = false;
+            continue;
+        }
+
+        if (pivot != k)
+        {
+            for (int j = first; j < last; j++)
+            {
+                double temp = lu[(size_t)k * size + j];
+
+                lu[(size_t)k * size + j] = lu[(size_t)pivot * size + j];
+                lu[(size_t)pivot * size + j] = temp;
+            }
+        }
+
+        const double *row = lu + (size_t)k * size;
+
+        for (int i = k + 1; i < size; i++)
+        {
+            double *target = lu + (size_t)i * size;
+            double coefficient = target[k] / row[k];
+
+            target[k] = coefficient;
+
+            for (int j = k + 1; j < last; j++)
+                target[j] -= coefficient * row[j];
+        }
+    }
+
+    return regular;
+}
+
+// Troca as linhas das colunas [first, last) de lu de acordo com os pivôs de [begin, end)
+void DenseSwapRows(double *lu, const int *pivots, int size, int begin, int end, int first, int last)
+{
+    for (int k = begin; k < end; k++)
+    {
+        if (pivots[k] == k)
+            continue;
+
+        double *row = lu + (size_t)k * size;
+        double *other = lu + (size_t)pivots[k] * size;
+
+        for (int j = first; j < last; j++)
+        {
+            double temp = row[j];
+
+            row[j] = other[j];
+            other[j] = temp;
+        }
+    }
+}
+
+// Subtrai de lu[i0:i1, j0:j1] o produto de lu[i0:i1, k0:k1] por lu[k0:k1, j0:j1]
+// Quatro linhas de lu[k0:k1, j0:j1] são combinadas por passagem, para ler e
+// gravar cada linha do bloco atualizado quatro vezes menos
+void DenseUpdateBlock(double *lu, int size, int i0, int i1, int j0, int j1, int k0, int k1)
+{
+    for (int r = i0; r < i1; r++)
+    {
+        double *target = lu + (size_t)r * size;
+        int p = k0;
+
+        for (; p + 4 <= k1; p += 4)
+        {
+            double c0 = target[p], c1 = target[p + 1], c2 = target[p + 2], c3 = target[p + 3];
+
+            const double *s0 = lu + (size_t)p * size;
+            const double *s1 = s0 + size;
+            const double *s2 = s1 + size;
+            const double *s3 = s2 + size;
+
+            for (int c = j0; c < j1; c++)
+                target[c] -= c0 * s0[c] + c1 * s1[c] + c2 * s2[c] + c3 * s3[c];
+        }
+
+        for (; p < k1; p++)
+        {
+            double coefficient = target[p];
+            const double *source = lu + (size_t)p * size;
+
+            for (int c = j0; c < j1; c++)
+                target[c] -= coefficient * source[c];
+        }
+    }
+}
+
+// Fatoração LU com pivoteamento parcial por blocos (right-looking): lu passa
+// a conter L (diagonal unitária implícita) abaixo da diagonal e U acima,
+// e pivots[k] é a linha trocada com a linha k
+// Cada passo fatora um painel de DNS_LU_BLOCK colunas, aplica as trocas e
+// a solução triangular às linhas do painel em cada bloco de colunas à
+// direita e atualiza os blocos restantes da matriz (L * U). Esses trabalhos
+// formam um grafo de tarefas: o painel seguinte só espera pela atualização
+// das suas próprias colunas, então ele é fatorado enquanto as atualizações
+// das demais colunas do passo anterior ainda são executadas
+// Retorna o sinal da permutação ou 0 caso a matriz seja singular
+int DenseFactorLU(double *lu, int *pivots, int size)
+{
+    int blocks = (size + DNS_LU_BLOCK - 1) / DNS_LU_BLOCK;
+
+    std::vector<char> regular(blocks, 1);
+
+    TaskGraph graph;
+
+    // Última tarefa que escreveu em cada bloco (i, j) da matriz, dos blocos ainda não concluídos
+    std::vector<int> writers((size_t)blocks * blocks, -1);
+
+    for (int k = 0; k < blocks; k++)
+    {
+        int k0 = k * DNS_LU_BLOCK;
+        int k1 = k0 + DNS_LU_BLOCK < size ? k0 + DNS_LU_BLOCK : size;
+
+        int panel = AddGraphNode(&graph, k, [=, &regular]()
+        {
+            regular[k] = DenseFactorPanel(lu, pivots, size, k0, k1);
+        });
+
+        for (int i = k; i < blocks; i++)
+        {
+            if (writers[(size_t)i * blocks + k] != -1)
+                AddGraphDependency(&graph, writers[(size_t)i * blocks + k], panel);
+        }
+
+        for (int j = k + 1; j < blocks; j++)
+        {
+            int j0 = j * DNS_LU_BLOCK;
+            int j1 = j0 + DNS_LU_BLOCK < size ? j0 + DNS_LU_BLOCK : size;
+
+            // Trocas de linha e U(k, j) = L(k, k)^-1 * A(k, j)
+            int row = AddGraphNode(&graph, j, [=]()
+            {
+                DenseSwapRows(lu, pivots, size, k0, k1, j0, j1);
+
+                for (int p = k0; p < k1; p++)
+                {
+                    const double *source = lu + (size_t)p * size;
+
+                    for (int r = p + 1; r < k1; r++)
+                    {
+                        double *target = lu + (size_t)r * size;
+                        double coefficient = target[p];
+
+                        for (int c = j0; c < j1; c++)
+                            target[c] -= coefficient * source[c];
+                    }
+                }
+            });
+
+            // As trocas podem mover qualquer linha abaixo de k0 dentro do bloco de colunas j
+            AddGraphDependency(&graph, panel, row);
+
+            for (int i = k; i < blocks; i++)
+            {
+                if (writers[(size_t)i * blocks + j] != -1)
+                    AddGraphDependency(&graph, writers[(size_t)i * blocks + j], row);
+            }
+
+            writers[(size_t)k * blocks + j] = row;
+
+            // A(i, j) -= L(i, k) * U(k, j)
+            for (int i = k + 1; i < blocks; i++)
+            {
+                int i0 = i * DNS_LU_BLOCK;
+                int i1 = i0 + DNS_LU_BLOCK < size ? i0 + DNS_LU_BLOCK : size;
+
+                int update = AddGraphNode(&graph, j, [=]()
+                {
+                    DenseUpdateBlock(lu, size, i0, i1, j0, j1, k0, k1);
+                });
+
+                AddGraphDependency(&graph, panel, update);
+                AddGraphDependency(&graph, row, update);
+
+                writers[(size_t)i * blocks + j] = update;
+            }
+        }
+    }
+
+    RunGraph(&graph);
+
+    // Trocas de cada painel nas colunas de L à sua esquerda, que as tarefas
+    // dos passos seguintes ainda liam durante a execução do grafo
+    for (int k = 1; k < blocks; k++)
+    {
+        int k0 = k * DNS_LU_BLOCK;
+        int k1 = k0 + DNS_LU_BLOCK < size ? k0 + DNS_LU_BLOCK : size;
+
+        DenseSwapRows(lu, pivots, size, k0, k1, 0, k0);
+    }
+
+    int signal = 1;
+
+    for (int k = 0; k < blocks; k++)
+    {
+        if (!regular[k])
+            return 0;
+    }
+
+    for (int k = 0; k < size; k++)
+    {
+        if (pivots[k] != k)
+            signal = -signal;
+    }
+
+    return signal;
+}
+
+// Resolve lu * x = b com os fatores de DenseFactorLU (b é sobrescrito por x)
+// As colunas de b são independentes e divididas entre as threads
+void DenseSubstituteLU(const double *lu, const int *pivots, double *b, int size, int columns)
+{
+    ParallelFor(0, columns, DNS_BLOCK, [=](int first, int last)
+    {
+        for (int k = 0; k < size; k++)
+        {
+            double *row = b + (size_t)k * columns;
+            double *other = b + (size_t)pivots[k] * columns;
+
+            if (pivots[k] != k)
+            {
+                for (int j = first; j < last; j++)
+                {
+                    double temp = row[j];
+
+                    row[j] = other[j];
+                    other[j] = temp;
+                }
+            }
+        }
+
+        for (int i = 0; i < size; i++)
+        {
+            double *target = b + (size_t)i * columns;
+
+            for (int k = 0; k < i; k++)
+            {
+                double coefficient = lu[(size_t)i * size + k];
+                const double *source = b + (size_t)k * columns;
+
+                for (int j = first; j < last; j++)
+                    target[j] -= coefficient * source[j];
+            }
+        }
+
+        for (int i = size - 1; i >= 0; i--)
+        {
+            double *target = b + (size_t)i * columns;
+
+            for (int k = i + 1; k < size; k++)
+            {
+                double coefficient = lu[(size_t)i * size + k];
+                const double *source = b + (size_t)k * columns;
+
+                for (int j = first; j < last; j++)
+                    target[j] -= coefficient * source[j];
+            }
+
+            double diagonal = lu[(size_t)i * size + i];
+
+            for (int j = first; j < last; j++)
+                target[j] /= diagonal;
+        }
+    });
+}
+
+// Resolve o sistema a * x = b, sendo a quadrada de ordem size e b com
+// columns colunas, pela fatoração LU com pivoteamento parcial
+// Retorna falso caso a matriz seja singular
+bool DenseSolve(const double *a, const double *b, double *x, int size, int columns)
+{
+    double *lu = (double *)malloc((size_t)size * size * sizeof(double));
+    int *pivots = (int *)malloc((size > 0 ? size : 1) * sizeof(int));
+
+    memcpy(lu, a, (size_t)size * size * sizeof(double));
+    memcpy(x, b, (size_t)size * columns * sizeof(double));
+
+    bool regular = DenseFactorLU(lu, pivots, size) != 0;
+
+    if (regular)
+        DenseSubstituteLU(lu, pivots, x, size, columns);
+
+    free(lu);
+    free(pivots);
+
+    return regular;
+}
+
+// Calcula a exponencial da matriz quadrada x por escalonamento e quadrados
+// sucessivos: exp(x) = exp(x / 2^s)^(2^s), sendo exp(x / 2^s) aproximada pelo
+// aproximante de Padé de grau DNS_PADE_DEGREE
+// Retorna falso caso o denominador do aproximante seja singular
+bool DenseExponential(const double *x, double *z, int size)
+{
+    size_t count = (size_t)size * size;
+
+    // Norma 1 (maior soma absoluta de coluna) define o escalonamento
+    double norm = 0;
+
+    for (int j = 0; j < size; j++)
+    {
+        double sum = 0;
+
+        for (int i = 0; i < size; i++)
+            sum += fabs(x[(size_t)i * size + j]);
+
+        if (sum > norm)
+            norm = sum;
+    }
+
+    int squarings = norm > 0.5 ? (int)ceil(log2(norm / 0.5)) : 0;
+    double scale = ldexp(1.0, -squarings);
+
+    double *a = (double *)malloc(count * sizeof(double));
+    double *power = (double *)malloc(count * sizeof(double));
+    double *temp = (double *)malloc(count * sizeof(double));
+    double *numerator = (double *)malloc(count * sizeof(double));
+    double *denominator = (double *)malloc(count * sizeof(double));
+
+    for (size_t k = 0; k < count; k++)
+        a[k] = x[k] * scale;
+
+    DenseIdentity(power, size);
+    DenseIdentity(numerator, size);
+    DenseIdentity(denominator, size);
+
+    double coefficient = 1;
+    double signal = 1;
+
+    for (int k = 1; k <= DNS_PADE_DEGREE; k++)
+    {
+        coefficient *= (double)(DNS_PADE_DEGREE - k + 1) / (k * (2 * DNS_PADE_DEGREE - k + 1));
+        signal *= -1;
+
+        DenseMultiply(power, a, temp, size, size, size);
+
+        double *swap = power;
+        power = temp;
+        temp = swap;
+
+        for (size_t l = 0; l < count; l++)
+        {
+            numerator[l] += coefficient * power[l];
+            denominator[l] += signal * coefficient * power[l];
+        }
+    }
+
+    bool regular = DenseSolve(denominator, numerator, z, size, size);
+
+    for (int k = 0; k < squarings && regular; k++)
+    {
+        DenseMultiply(z, z, temp, size, size, size);
+        memcpy(z, temp, count * sizeof(double));
+    }
+
+    free(a);
+    free(power);
+    free(temp);
+    free(numerator);
+    free(denominator);
+
+    return regular;
+}
+
+#endif
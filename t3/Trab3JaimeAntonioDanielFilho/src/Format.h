@@ -0,0 +1,187 @@
+/*********************************************************************
+// Format.h
+// Formatação de números com uma quantidade fixa de casas decimais, com o
+// mesmo resultado do printf("%.Nf") mas sem interpretar o formato nem
+// consultar o locale a cada chamada. O valor é escalado de forma exata
+// com inteiros de 128 bits e arredondado para o par mais próximo nos
+// empates, como faz o printf. Valores muito grandes, infinitos ou NaN
+// recorrem ao snprintf.
+// *********************************************************************/
+
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Maior quantidade de casas decimais do caminho rápido
+#define FMT_MAX_DECIMALS 9
+
+// Maior valor absoluto do caminho rápido (2^53, a partir do qual todo double é inteiro)
+#define FMT_MAX_VALUE 9007199254740992.0
+
+static const char formatDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint64_t formatPowers[FMT_MAX_DECIMALS + 1] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull,
+    1000000ull, 10000000ull, 100000000ull, 1000000000ull};
+
+// Interpreta um formato do tipo "%.Nf" e retorna N, ou -1 caso o formato
+// não seja suportado pelo caminho rápido
+int ParseFixedFormat(const char *format)
+{
+    if (format[0] != '%')
+        return -1;
+
+    int decimals = 6;
+    const char *cursor = format + 1;
+
+    if (*cursor == '.')
+    {
+        decimals = 0;
+        cursor++;
+
+        while (*cursor >= '0' && *cursor <= '9')
+            decimals = 10 * decimals + (*cursor++ - '0');
+    }
+
+    if (cursor[0] != 'f' || cursor[1] != '\0' || decimals > FMT_MAX_DECIMALS)
+        return -1;
+
+    return decimals;
+}
+
+// Escreve os dígitos de um inteiro sem sinal, completando com zeros à
+// esquerda até width dígitos. Retorna a quantidade de caracteres escritos
+int WriteDigits(uint64_t value, int width, char *destination)
+{
+    char buffer[24];
+    int length = 0;
+
+    while (value >= 100)
+    {
+        const char *pair = formatDigitPairs + 2 * (value % 100);
+        value /= 100;
+
+        buffer[length++] = pair[1];
+        buffer[length++] = pair[0];
+    }
+
+    if (value >= 10)
+    {
+        buffer[length++] = formatDigitPairs[2 * value + 1];
+        buffer[length++] = formatDigitPairs[2 * value];
+    }
+    else
+    {
+        buffer[length++] = (char)('0' + value);
+    }
+
+    while (length < width)
+        buffer[length++] = '0';
+
+    for (int k = 0; k < length; k++)
+        destination[k] = buffer[length - 1 - k];
+
+    return length;
+}
+
+// Escreve o valor com tal quantidade de casas decimais, como printf("%.Nf")
+// Retorna o comprimento do texto completo (sem o terminador), que, como no
+// snprintf, pode ser maior do que o destino quando o texto não cabe nele
+int FormatFixed(double value, int decimals, char *destination, int capacity)
+{
+    double magnitude = fabs(value);
+
+    // A parte inteira, o ponto, as casas, o sinal e o terminador precisam caber no destino
+    if (!(magnitude < FMT_MAX_VALUE) || decimals < 0 || decimals > FMT_MAX_DECIMALS || capacity < 20 + decimals)
+    {
+        return snprintf(destination, capacity, "%.*f", decimals, value);
+    }
+
+    // magnitude = mantissa * 2^exponent, lidos diretamente dos bits do double
+    uint64_t bits;
+    memcpy(&bits, &magnitude, sizeof(bits));
+
+    uint64_t mantissa = bits & ((1ull << 52) - 1);
+    int exponent = (int)(bits >> 52);
+
+    if (exponent == 0)
+    {
+        exponent = -1074;
+    }
+    else
+    {
+        mantissa |= 1ull << 52;
+        exponent -= 1075;
+    }
+
+    // scaled = magnitude * 10^decimals, arredondado para o par mais próximo
+    unsigned __int128 scaled = (unsigned __int128)mantissa * formatPowers[decimals];
+
+    if (exponent >= 0)
+    {
+        scaled <<= exponent;
+    }
+    else if (-exponent >= 128)
+    {
+        scaled = 0;
+    }
+    else
+    {
+        int shift = -exponent;
+
+        unsigned __int128 remainder = scaled & ((((unsigned __int128)1) << shift) - 1);
+        unsigned __int128 half = ((unsigned __int128)1) << (shift - 1);
+
+        scaled >>= shift;
+
+        if (remainder > half || (remainder == half && (scaled & 1)))
+            scaled++;
+    }
+
+    uint64_t integer, decimal;
+
+    // A divisão de 128 bits é bem mais lenta e só é necessária para valores grandes
+    if ((uint64_t)(scaled >> 64) == 0)
+    {
+        integer = (uint64_t)scaled / formatPowers[decimals];
+        decimal = (uint64_t)scaled % formatPowers[decimals];
+    }
+    else
+    {
+        integer = (uint64_t)(scaled / formatPowers[decimals]);
+        decimal = (uint64_t)(scaled % formatPowers[decimals]);
+    }
+
+    int length = 0;
+
+    if (signbit(value))
+        destination[length++] = '-';
+
+    length += WriteDigits(integer, 1, destination + length);
+
+    if (decimals > 0)
+    {
+        destination[length++] = '.';
+        length += WriteDigits(decimal, decimals, destination + length);
+    }
+
+    destination[length] = '\0';
+
+    return length;
+}
+
+#endif
@@ -0,0 +1,367 @@
+/*********************************************************************
+// Heatmap.h
+// Mapa de calor de uma matriz para quando o zoom é pequeno demais para os
+// números. Os valores são reduzidos em uma pirâmide: cada nível guarda o
+// mínimo, o máximo e a média de blocos 2x2 do nível anterior, até restar
+// um único bloco. Apenas a região alterada desde a última consulta é
+// recalculada, subindo os níveis. Um nível da pirâmide é enviado como
+// textura e desenhado de uma vez, e só a região alterada é reenviada.
+// *********************************************************************/
+
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+#include <GL/glut.h>
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+#define HMP_MAX_LEVELS 24
+
+// Maior lado da textura enviada (níveis maiores são trocados pelo seguinte)
+#define HMP_MAX_TEXTURE 2048
+
+typedef struct
+{
+    int rows, columns;
+
+    // No nível 0 os três apontam para os próprios valores das células
+    float *min, *max, *mean;
+} HeatmapLevel;
+
+typedef struct
+{
+    int levels;
+    HeatmapLevel level[HMP_MAX_LEVELS];
+
+    // Região do nível 0 alterada desde a última atualização dos demais níveis (vazia se first > last)
+    int dirtyFirstI, dirtyLastI, dirtyFirstJ, dirtyLastJ;
+
+    // Região do nível 0 alterada desde o último envio da textura
+    int uploadFirstI, uploadLastI, uploadFirstJ, uploadLastJ;
+
+    GLuint texture;
+
+    // Nível enviado para a textura (-1 caso nenhum) e o maior valor absoluto usado nas cores
+    int textureLevel;
+    float textureScale;
+} Heatmap;
+
+// Inicia o mapa de calor vazio
+void InitializeHeatmap(Heatmap *heatmap)
+{
+    heatmap->levels = 0;
+    heatmap->texture = 0;
+    heatmap->textureLevel = -1;
+    heatmap->textureScale = 0;
+
+    heatmap->dirtyFirstI = heatmap->uploadFirstI = 0;
+    heatmap->dirtyLastI = heatmap->uploadLastI = -1;
+    heatmap->dirtyFirstJ = heatmap->uploadFirstJ = 0;
+    heatmap->dirtyLastJ = heatmap->uploadLastJ = -1;
+}
+
+// Retorna o número de linhas do nível 0
+int HeatmapRows(Heatmap *heatmap)
+{
+    return heatmap->levels > 0 ? heatmap->level[0].rows : 0;
+}
+
+// Retorna o número de colunas do nível 0
+int HeatmapColumns(Heatmap *heatmap)
+{
+    return heatmap->levels > 0 ? heatmap->level[0].columns : 0;
+}
+
+// Libera os níveis da pirâmide
+void FreeHeatmapLevels(Heatmap *heatmap)
+{
+    for (int l = 0; l < heatmap->levels; l++)
+    {
+        free(heatmap->level[l].mean);
+
+        if (l > 0)
+        {
+            free(heatmap->level[l].min);
+            free(heatmap->level[l].max);
+        }
+    }
+
+    heatmap->levels = 0;
+}
+
+// Acrescenta uma região alterada (no nível 0) à região acumulada
+void ExpandHeatmapRegion(int *firstI, int *lastI, int *firstJ, int *lastJ, int fromI, int toI, int fromJ, int toJ)
+{
+    if (*firstI > *lastI || *firstJ > *lastJ)
+    {
+        *firstI = fromI;
+        *lastI = toI;
+        *firstJ = fromJ;
+        *lastJ = toJ;
+        return;
+    }
+
+    if (fromI < *firstI)
+        *firstI = fromI;
+
+    if (toI > *lastI)
+        *lastI = toI;
+
+    if (fromJ < *firstJ)
+        *firstJ = fromJ;
+
+    if (toJ > *lastJ)
+        *lastJ = toJ;
+}
+
+// Recria a pirâmide para novas dimensões, com todos os valores zerados
+void ResizeHeatmap(Heatmap *heatmap, int rows, int columns)
+{
+    FreeHeatmapLevels(heatmap);
+
+    if (rows <= 0 || columns <= 0)
+        return;
+
+    int levelRows = rows;
+    int levelColumns = columns;
+
+    while (heatmap->levels < HMP_MAX_LEVELS)
+    {
+        HeatmapLevel *level = &heatmap->level[heatmap->levels++];
+
+        size_t count = (size_t)levelRows * levelColumns;
+
+        level->rows = levelRows;
+        level->columns = levelColumns;
+        level->mean = (float *)calloc(count, sizeof(float));
+
+        if (heatmap->levels == 1)
+        {
+            level->min = level->mean;
+            level->max = level->mean;
+        }
+        else
+        {
+            level->min = (float *)calloc(count, sizeof(float));
+            level->max = (float *)calloc(count, sizeof(float));
+        }
+
+        if (levelRows == 1 && levelColumns == 1)
+            break;
+
+        levelRows = (levelRows + 1) / 2;
+        levelColumns = (levelColumns + 1) / 2;
+    }
+
+    heatmap->dirtyFirstI = 0;
+    heatmap->dirtyLastI = rows - 1;
+    heatmap->dirtyFirstJ = 0;
+    heatmap->dirtyLastJ = columns - 1;
+
+    heatmap->textureLevel = -1;
+}
+
+// Define o valor de uma célula, que só chega aos níveis superiores em RefreshHeatmap
+void SetHeatmapValue(Heatmap *heatmap, int i, int j, double value)
+{
+    if (i < 0 || i >= HeatmapRows(heatmap) || j < 0 || j >= HeatmapColumns(heatmap))
+        return;
+
+    heatmap->level[0].mean[i * heatmap->level[0].columns + j] = (float)value;
+
+    ExpandHeatmapRegion(
+        &heatmap->dirtyFirstI, &heatmap->dirtyLastI,
+        &heatmap->dirtyFirstJ, &heatmap->dirtyLastJ,
+        i, i, j, j);
+}
+
+// Calcula quantas células do nível 0 um índice de tal nível cobre em uma dimensão
+int HeatmapSpan(int size, int level, int index)
+{
+    int first = index << level;
+    int last = (index + 1) << level;
+
+    return (last < size ? last : size) - first;
+}
+
+// Recalcula os blocos dos níveis superiores que cobrem a região alterada
+void RefreshHeatmap(Heatmap *heatmap)
+{
+    if (heatmap->dirtyFirstI > heatmap->dirtyLastI)
+        return;
+
+    int rows = HeatmapRows(heatmap);
+    int columns = HeatmapColumns(heatmap);
+
+    for (int l = 1; l < heatmap->levels; l++)
+    {
+        HeatmapLevel *level = &heatmap->level[l];
+        HeatmapLevel *below = &heatmap->level[l - 1];
+
+        int lastI = heatmap->dirtyLastI >> l;
+        int lastJ = heatmap->dirtyLastJ >> l;
+
+        for (int i = heatmap->dirtyFirstI >> l; i <= lastI; i++)
+        {
+            for (int j = heatmap->dirtyFirstJ >> l; j <= lastJ; j++)
+            {
+                float minimum = FLT_MAX, maximum = -FLT_MAX;
+                double sum = 0;
+
+                // Filhos nas bordas podem faltar ou cobrir menos células
+                for (int childI = 2 * i; childI < 2 * i + 2 && childI < below->rows; childI++)
+                {
+                    for (int childJ = 2 * j; childJ < 2 * j + 2 && childJ < below->columns; childJ++)
+                    {
+                        int child = childI * below->columns + childJ;
+                        int count = HeatmapSpan(rows, l - 1, childI) * HeatmapSpan(columns, l - 1, childJ);
+
+                        minimum = fminf(minimum, below->min[child]);
+                        maximum = fmaxf(maximum, below->max[child]);
+                        sum += (double)below->mean[child] * count;
+                    }
+                }
+
+                int index = i * level->columns + j;
+
+                level->min[index] = minimum;
+                level->max[index] = maximum;
+                level->mean[index] = (float)(sum / (HeatmapSpan(rows, l, i) * HeatmapSpan(columns, l, j)));
+            }
+        }
+    }
+
+    ExpandHeatmapRegion(
+        &heatmap->uploadFirstI, &heatmap->uploadLastI,
+        &heatmap->uploadFirstJ, &heatmap->uploadLastJ,
+        heatmap->dirtyFirstI, heatmap->dirtyLastI, heatmap->dirtyFirstJ, heatmap->dirtyLastJ);
+
+    heatmap->dirtyFirstI = 0;
+    heatmap->dirtyLastI = -1;
+    heatmap->dirtyFirstJ = 0;
+    heatmap->dirtyLastJ = -1;
+}
+
+// Escolhe o menor nível no qual um bloco ocupa pelo menos um pixel e que cabe na textura
+// cellWidth e cellHeight são o tamanho (em pixels) de uma célula do nível 0 na tela
+int ChooseHeatmapLevel(Heatmap *heatmap, float cellWidth, float cellHeight)
+{
+    float cellSize = fminf(cellWidth, cellHeight);
+
+    for (int l = 0; l < heatmap->levels; l++)
+    {
+        HeatmapLevel *level = &heatmap->level[l];
+
+        bool visible = cellSize * (1 << l) >= 1;
+        bool fits = level->rows <= HMP_MAX_TEXTURE && level->columns <= HMP_MAX_TEXTURE;
+
+        if (visible && fits)
+            return l;
+    }
+
+    return heatmap->levels - 1;
+}
+
+// Converte um valor em cor: azul para negativos, branco para zero e vermelho para positivos,
+// com a intensidade relativa ao maior valor absoluto da matriz
+void HeatmapColor(float value, float scale, unsigned char *color)
+{
+    float t = scale > 0 ? value / scale : 0;
+
+    t = fminf(fmaxf(t, -1), 1);
+
+    unsigned char fade = (unsigned char)(255 * (1 - fabsf(t)));
+
+    color[0] = t < 0 ? fade : 255;
+    color[1] = fade;
+    color[2] = t > 0 ? fade : 255;
+}
+
+// Calcula o maior valor absoluto da matriz, guardado no último nível
+float HeatmapScale(Heatmap *heatmap)
+{
+    HeatmapLevel *root = &heatmap->level[heatmap->levels - 1];
+
+    return fmaxf(fabsf(root->min[0]), fabsf(root->max[0]));
+}
+
+// Envia à textura os blocos de um nível dentro de uma região (em índices desse nível)
+void UploadHeatmapRegion(Heatmap *heatmap, int l, int firstI, int lastI, int firstJ, int lastJ, bool whole)
+{
+    HeatmapLevel *level = &heatmap->level[l];
+
+    float scale = heatmap->textureScale;
+
+    int width = lastJ - firstJ + 1;
+    int height = lastI - firstI + 1;
+
+    unsigned char *pixels = (unsigned char *)malloc((size_t)width * height * 3);
+
+    for (int i = 0; i < height; i++)
+    {
+        for (int j = 0; j < width; j++)
+            HeatmapColor(level->mean[(firstI + i) * level->columns + firstJ + j], scale, &pixels[3 * (i * width + j)]);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    if (whole)
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+    else
+        glTexSubImage2D(GL_TEXTURE_2D, 0, firstJ, firstI, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+
+    free(pixels);
+}
+
+// Deixa a textura com o nível escolhido e atualizado, enviando apenas o necessário
+// A textura fica associada ao GL_TEXTURE_2D
+void UpdateHeatmapTexture(Heatmap *heatmap, int l)
+{
+    RefreshHeatmap(heatmap);
+
+    if (heatmap->texture == 0)
+    {
+        glGenTextures(1, &heatmap->texture);
+        glBindTexture(GL_TEXTURE_2D, heatmap->texture);
+
+        // Blocos maiores do que um pixel ficam nítidos; menores são suavizados
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, heatmap->texture);
+
+    HeatmapLevel *level = &heatmap->level[l];
+
+    if (heatmap->uploadFirstI > heatmap->uploadLastI && heatmap->textureLevel == l)
+        return;
+
+    // As cores dependem do maior valor absoluto, então uma alteração dele refaz a textura inteira
+    float scale = HeatmapScale(heatmap);
+
+    if (heatmap->textureLevel != l || scale != heatmap->textureScale)
+    {
+        heatmap->textureScale = scale;
+        UploadHeatmapRegion(heatmap, l, 0, level->rows - 1, 0, level->columns - 1, true);
+    }
+    else
+    {
+        UploadHeatmapRegion(
+            heatmap, l,
+            heatmap->uploadFirstI >> l, heatmap->uploadLastI >> l,
+            heatmap->uploadFirstJ >> l, heatmap->uploadLastJ >> l,
+            false);
+    }
+
+    heatmap->textureLevel = l;
+
+    heatmap->uploadFirstI = 0;
+    heatmap->uploadLastI = -1;
+    heatmap->uploadFirstJ = 0;
+    heatmap->uploadLastJ = -1;
+}
+
+#endif
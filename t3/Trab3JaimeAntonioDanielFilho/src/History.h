@@ -0,0 +1,238 @@
+/*********************************************************************
+// History.h
+// Histórico para desfazer e refazer alterações em matrizes. Cada registro
+// guarda os valores de cada matriz (linha por linha) divididos em pedaços
+// de tamanho fixo com contagem de referências: um pedaço que não mudou é
+// compartilhado com o registro anterior, então um registro só ocupa a
+// memória dos pedaços alterados. Quando a memória passa do orçamento, os
+// registros mais antigos são descartados.
+// *********************************************************************/
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdlib.h>
+#include <string.h>
+
+// Quantidade de valores por pedaço
+#define HST_CHUNK_SIZE 1024
+
+#define HST_MAX_ENTRIES 1024
+#define HST_MAX_MATRICES 4
+
+typedef struct
+{
+    int references;
+    int count;
+    double values[HST_CHUNK_SIZE];
+} HistoryChunk;
+
+// Valores de uma matriz em um ponto do histórico
+typedef struct
+{
+    int rows, columns;
+
+    int chunkCount;
+    HistoryChunk **chunks;
+} HistorySnapshot;
+
+typedef struct
+{
+    HistorySnapshot snapshots[HST_MAX_MATRICES];
+} HistoryEntry;
+
+typedef struct
+{
+    int matrices;
+
+    // Fila circular dos registros, do mais antigo ao mais recente
+    HistoryEntry entries[HST_MAX_ENTRIES];
+    int first, count;
+
+    // Registro que corresponde ao estado atual das matrizes (-1 caso vazio)
+    int current;
+
+    // Registro sendo montado por BeginHistoryEntry
+    HistoryEntry pending;
+
+    // Memória ocupada pelos pedaços e pelas listas de pedaços
+    size_t bytes, budget;
+} History;
+
+// Inicia o histórico vazio para tal quantidade de matrizes, limitado a budget bytes
+void InitializeHistory(History *history, int matrices, size_t budget)
+{
+    history->matrices = matrices;
+
+    history->first = 0;
+    history->count = 0;
+    history->current = -1;
+
+    history->bytes = 0;
+    history->budget = budget;
+}
+
+// Retorna o registro na posição k, contada a partir do mais antigo
+HistoryEntry *HistoryEntryAt(History *history, int k)
+{
+    return &history->entries[(history->first + k) % HST_MAX_ENTRIES];
+}
+
+// Retorna o registro do estado atual (NULL caso o histórico esteja vazio)
+HistoryEntry *CurrentHistoryEntry(History *history)
+{
+    return history->current >= 0 ? HistoryEntryAt(history, history->current) : NULL;
+}
+
+// Solta as referências de um registro de matriz, liberando os pedaços que ficarem sem dono
+void ReleaseSnapshot(History *history, HistorySnapshot *snapshot)
+{
+    for (int k = 0; k < snapshot->chunkCount; k++)
+    {
+        HistoryChunk *chunk = snapshot->chunks[k];
+
+        if (chunk != NULL && --chunk->references == 0)
+        {
+            free(chunk);
+            history->bytes -= sizeof(HistoryChunk);
+        }
+    }
+
+    free(snapshot->chunks);
+    history->bytes -= snapshot->chunkCount * sizeof(HistoryChunk *);
+
+    snapshot->chunks = NULL;
+    snapshot->chunkCount = 0;
+}
+
+// Solta todos os registros de matriz de um registro
+void ReleaseHistoryEntry(History *history, HistoryEntry *entry)
+{
+    for (int m = 0; m < history->matrices; m++)
+        ReleaseSnapshot(history, &entry->snapshots[m]);
+}
+
+// Começa um registro de matriz com tais dimensões, compartilhando todos os pedaços
+// do registro anterior (NULL caso não exista) até que StoreSnapshotChunk os troque
+void BeginSnapshot(History *history, const HistorySnapshot *previous, int rows, int columns, HistorySnapshot *snapshot)
+{
+    int count = rows * columns;
+
+    snapshot->rows = rows;
+    snapshot->columns = columns;
+    snapshot->chunkCount = (count + HST_CHUNK_SIZE - 1) / HST_CHUNK_SIZE;
+    snapshot->chunks = (HistoryChunk **)malloc(snapshot->chunkCount * sizeof(HistoryChunk *));
+
+    history->bytes += snapshot->chunkCount * sizeof(HistoryChunk *);
+
+    for (int k = 0; k < snapshot->chunkCount; k++)
+    {
+        HistoryChunk *chunk = previous != NULL && k < previous->chunkCount ? previous->chunks[k] : NULL;
+
+        if (chunk != NULL)
+            chunk->references++;
+
+        snapshot->chunks[k] = chunk;
+    }
+}
+
+// Guarda os valores de um pedaço do registro, que só é copiado caso seja diferente do compartilhado
+// Retorna verdadeiro caso um novo pedaço tenha sido criado
+bool StoreSnapshotChunk(History *history, HistorySnapshot *snapshot, int k, const double *values, int count)
+{
+    HistoryChunk *shared = snapshot->chunks[k];
+
+    if (shared != NULL && shared->count == count && memcmp(shared->values, values, count * sizeof(double)) == 0)
+        return false;
+
+    HistoryChunk *chunk = (HistoryChunk *)malloc(sizeof(HistoryChunk));
+
+    chunk->references = 1;
+    chunk->count = count;
+    memcpy(chunk->values, values, count * sizeof(double));
+
+    history->bytes += sizeof(HistoryChunk);
+
+    if (shared != NULL && --shared->references == 0)
+    {
+        free(shared);
+        history->bytes -= sizeof(HistoryChunk);
+    }
+
+    snapshot->chunks[k] = chunk;
+
+    return true;
+}
+
+// Retorna o registro a ser preenchido com um BeginSnapshot por matriz
+// O registro só entra no histórico com CommitHistoryEntry
+HistoryEntry *BeginHistoryEntry(History *history)
+{
+    return &history->pending;
+}
+
+// Descarta o registro sendo montado
+void CancelHistoryEntry(History *history)
+{
+    ReleaseHistoryEntry(history, &history->pending);
+}
+
+// Descarta o registro mais antigo
+void DropOldestHistoryEntry(History *history)
+{
+    ReleaseHistoryEntry(history, HistoryEntryAt(history, 0));
+
+    history->first = (history->first + 1) % HST_MAX_ENTRIES;
+    history->count--;
+    history->current--;
+}
+
+// Coloca o registro montado após o atual, descartando os que poderiam ser refeitos,
+// e respeita o orçamento de memória descartando os mais antigos
+void CommitHistoryEntry(History *history)
+{
+    while (history->count > history->current + 1)
+    {
+        ReleaseHistoryEntry(history, HistoryEntryAt(history, history->count - 1));
+        history->count--;
+    }
+
+    if (history->count == HST_MAX_ENTRIES)
+        DropOldestHistoryEntry(history);
+
+    *HistoryEntryAt(history, history->count) = history->pending;
+
+    history->count++;
+    history->current = history->count - 1;
+
+    // O registro atual é sempre mantido, mesmo que sozinho passe do orçamento
+    while (history->bytes > history->budget && history->current > 0)
+        DropOldestHistoryEntry(history);
+}
+
+// Verifica se existe um registro anterior ao atual
+bool CanUndoHistory(History *history)
+{
+    return history->current > 0;
+}
+
+// Verifica se existe um registro posterior ao atual
+bool CanRedoHistory(History *history)
+{
+    return history->current + 1 < history->count;
+}
+
+// Move o registro atual em tal quantidade de passos (-1 desfaz e 1 refaz) e o retorna
+HistoryEntry *StepHistory(History *history, int steps)
+{
+    int target = history->current + steps;
+
+    if (target < 0 || target >= history->count)
+        return NULL;
+
+    history->current = target;
+
+    return HistoryEntryAt(history, target);
+}
+
+#endif
@@ -0,0 +1,462 @@
+/*********************************************************************
+// Krylov.h
+// Métodos iterativos para sistemas esparsos: Gradiente Conjugado para
+// matrizes simétricas definidas positivas e GMRES com reinício para as
+// demais. Ambos aceitam os precondicionadores de Jacobi e ILU(0) e
+// registram a norma relativa do resíduo a cada iteração.
+// *********************************************************************/
+
+#ifndef KRYLOV_H
+#define KRYLOV_H
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "Parallel.h"
+#include "Sparse.h"
+#include "Task.h"
+
+#define KRY_NONE 0
+#define KRY_JACOBI 1
+#define KRY_ILU0 2
+
+// Quantidade máxima de resíduos guardados no histórico
+#define KRY_HISTORY_SIZE 512
+
+// Quantidade mínima de elementos processados por thread nas operações vetoriais
+#define KRY_PARALLEL_GRAIN 16384
+
+typedef struct
+{
+    int type;
+
+    // Jacobi: inverso da diagonal
+    double *inverseDiagonal;
+
+    // ILU(0): fatores L e U no padrão de esparsidade da matriz
+    SparseMatrix factors;
+    int *diagonal;
+} Preconditioner;
+
+typedef struct
+{
+    int iterations;
+    bool converged;
+
+    double residuals[KRY_HISTORY_SIZE];
+} KrylovHistory;
+
+// Registra a norma relativa do resíduo de uma iteração no histórico
+void RecordKrylovResidual(KrylovHistory *history, double residual)
+{
+    if (history->iterations < KRY_HISTORY_SIZE)
+        history->residuals[history->iterations] = residual;
+
+    history->iterations++;
+}
+
+// Calcula o produto escalar de dois vetores
+double KrylovDot(const double *a, const double *b, int length)
+{
+    if (length < 2 * KRY_PARALLEL_GRAIN)
+    {
+        double sum = 0;
+
+        for (int k = 0; k < length; k++)
+            sum += a[k] * b[k];
+
+        return sum;
+    }
+
+    std::vector<double> partials(ParallelThreadCount(), 0);
+    int blockSize = (length + (int)partials.size() - 1) / (int)partials.size();
+
+    ParallelFor(0, (int)partials.size(), 1, [&](int first, int last)
+    {
+        for (int t = first; t < last; t++)
+        {
+            int end = (t + 1) * blockSize < length ? (t + 1) * blockSize : length;
+
+            for (int k = t * blockSize; k < end; k++)
+                partials[t] += a[k] * b[k];
+        }
+    });
+
+    double sum = 0;
+
+    for (size_t t = 0; t < partials.size(); t++)
+        sum += partials[t];
+
+    return sum;
+}
+
+// Prepara o precondicionador de tal tipo para a matriz
+// Retorna falso caso algum elemento da diagonal seja nulo
+bool InitializePreconditioner(Preconditioner *preconditioner, const SparseMatrix *matrix, int type)
+{
+    int size = matrix->rows;
+
+    preconditioner->type = type;
+    preconditioner->inverseDiagonal = NULL;
+    preconditioner->diagonal = NULL;
+
+    memset(&preconditioner->factors, 0, sizeof(SparseMatrix));
+
+    if (type == KRY_NONE)
+        return true;
+
+    if (type == KRY_JACOBI)
+    {
+        preconditioner->inverseDiagonal = (double *)malloc(size * sizeof(double));
+
+        for (int i = 0; i < size; i++)
+        {
+            int position = SparseFind(matrix, i, i);
+
+            if (position < 0 || matrix->values[position] == 0)
+                return false;
+
+            preconditioner->inverseDiagonal[i] = 1 / matrix->values[position];
+        }
+
+        return true;
+    }
+
+    // ILU(0): eliminação gaussiana que descarta todo preenchimento fora do padrão original
+    SparseMatrix *factors = &preconditioner->factors;
+
+    InitializeSparse(factors, size, size, matrix->nonzeros);
+
+    memcpy(factors->offsets, matrix->offsets, (size + 1) * sizeof(int));
+    memcpy(factors->indices, matrix->indices, matrix->nonzeros * sizeof(int));
+    memcpy(factors->values, matrix->values, matrix->nonzeros * sizeof(double));
+
+    preconditioner->diagonal = (int *)malloc(size * sizeof(int));
+
+    for (int i = 0; i < size; i++)
+    {
+        preconditioner->diagonal[i] = SparseFind(factors, i, i);
+
+        if (preconditioner->diagonal[i] < 0)
+            return false;
+    }
+
+    for (int i = 1; i < size; i++)
+    {
+        for (int p = factors->offsets[i]; p < factors->offsets[i + 1] && factors->indices[p] < i; p++)
+        {
+            int k = factors->indices[p];
+            double pivot = factors->values[preconditioner->diagonal[k]];
+
+            if (pivot == 0)
+                return false;
+
+            factors->values[p] /= pivot;
+
+            // Atualiza os elementos (i, j) com j > k que existem tanto na linha i quanto na linha k
+            int q = p + 1;
+
+            for (int r = preconditioner->diagonal[k] + 1; r < factors->offsets[k + 1]; r++)
+            {
+                while (q < factors->offsets[i + 1] && factors->indices[q] < factors->indices[r])
+                    q++;
+
+                if (q < factors->offsets[i + 1] && factors->indices[q] == factors->indices[r])
+                    factors->values[q] -= factors->values[p] * factors->values[r];
+            }
+        }
+    }
+
+    for (int i = 0; i < size; i++)
+    {
+        if (factors->values[preconditioner->diagonal[i]] == 0)
+            return false;
+    }
+
+    return true;
+}
+
+// Libera a memória ocupada pelo precondicionador
+void FreePreconditioner(Preconditioner *preconditioner)
+{
+    free(preconditioner->inverseDiagonal);
+    free(preconditioner->diagonal);
+
+    if (preconditioner->type == KRY_ILU0)
+        FreeSparse(&preconditioner->factors);
+
+    preconditioner->inverseDiagonal = NULL;
+    preconditioner->diagonal = NULL;
+}
+
+// Aplica o precondicionador: z = M^-1 * r
+void ApplyPreconditioner(const Preconditioner *preconditioner, const double *r, double *z, int size)
+{
+    if (preconditioner->type == KRY_NONE)
+    {
+        memcpy(z, r, size * sizeof(double));
+    }
+    else if (preconditioner->type == KRY_JACOBI)
+    {
+        for (int i = 0; i < size; i++)
+            z[i] = r[i] * preconditioner->inverseDiagonal[i];
+    }
+    else
+    {
+        const SparseMatrix *factors = &preconditioner->factors;
+
+        // L * w = r (L com diagonal unitária)
+        for (int i = 0; i < size; i++)
+        {
+            double value = r[i];
+
+            for (int p = factors->offsets[i]; p < preconditioner->diagonal[i]; p++)
+                value -= factors->values[p] * z[factors->indices[p]];
+
+            z[i] = value;
+        }
+
+        // U * z = w
+        for (int i = size - 1; i >= 0; i--)
+        {
+            double value = z[i];
+
+            for (int p = preconditioner->diagonal[i] + 1; p < factors->offsets[i + 1]; p++)
+                value -= factors->values[p] * z[factors->indices[p]];
+
+            z[i] = value / factors->values[preconditioner->diagonal[i]];
+        }
+    }
+}
+
+// Gradiente Conjugado precondicionado para matrizes simétricas definidas positivas
+// x contém a estimativa inicial e recebe a solução
+void ConjugateGradient(const SparseMatrix *matrix, const Preconditioner *preconditioner, const double *b, double *x, double tolerance, int maxIterations, KrylovHistory *history, Task *task = NULL)
+{
+    int size = matrix->rows;
+
+    double *r = (double *)malloc(size * sizeof(double));
+    double *z = (double *)malloc(size * sizeof(double));
+    double *p = (double *)malloc(size * sizeof(double));
+    double *q = (double *)malloc(size * sizeof(double));
+
+    history->iterations = 0;
+    history->converged = false;
+
+    double norm = sqrt(KrylovDot(b, b, size));
+
+    if (norm == 0)
+        norm = 1;
+
+    SparseMultiplyVector(matrix, x, q);
+
+    for (int i = 0; i < size; i++)
+        r[i] = b[i] - q[i];
+
+    ApplyPreconditioner(preconditioner, r, z, size);
+    memcpy(p, z, size * sizeof(double));
+
+    double rz = KrylovDot(r, z, size);
+    double residual = sqrt(KrylovDot(r, r, size)) / norm;
+
+    RecordKrylovResidual(history, residual);
+
+    for (int iteration = 0; iteration < maxIterations && residual > tolerance && !IsTaskCancelled(task); iteration++)
+    {
+        SparseMultiplyVector(matrix, p, q);
+
+        double alpha = rz / KrylovDot(p, q, size);
+
+        for (int i = 0; i < size; i++)
+        {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+        }
+
+        ApplyPreconditioner(preconditioner, r, z, size);
+
+        double next = KrylovDot(r, z, size);
+        double beta = next / rz;
+
+        rz = next;
+
+        for (int i = 0; i < size; i++)
+            p[i] = z[i] + beta * p[i];
+
+        residual = sqrt(KrylovDot(r, r, size)) / norm;
+        RecordKrylovResidual(history, residual);
+
+        SetTaskProgress(task, (float)(iteration + 1) / maxIterations);
+    }
+
+    history->converged = residual <= tolerance;
+
+    free(r);
+    free(z);
+    free(p);
+    free(q);
+}
+
+// GMRES com reinício a cada restart iterações e precondicionamento à direita
+// x contém a estimativa inicial e recebe a solução
+void Gmres(const SparseMatrix *matrix, const Preconditioner *preconditioner, const double *b, double *x, int restart, double tolerance, int maxIterations, KrylovHistory *history, Task *task = NULL)
+{
+    int size = matrix->rows;
+
+    // Base de Krylov (restart + 1 vetores) e matriz de Hessenberg ((restart + 1) x restart)
+    double *basis = (double *)malloc((size_t)(restart + 1) * size * sizeof(double));
+    double *hessenberg = (double *)calloc((size_t)(restart + 1) * restart, sizeof(double));
+
+    double *cosines = (double *)malloc(restart * sizeof(double));
+    double *sines = (double *)malloc(restart * sizeof(double));
+    double *g = (double *)malloc((restart + 1) * sizeof(double));
+    double *y = (double *)malloc(restart * sizeof(double));
+
+    double *w = (double *)malloc(size * sizeof(double));
+    double *z = (double *)malloc(size * sizeof(double));
+
+    history->iterations = 0;
+    history->converged = false;
+
+    double norm = sqrt(KrylovDot(b, b, size));
+
+    if (norm == 0)
+        norm = 1;
+
+    int iteration = 0;
+    double residual = 0;
+
+    while (true)
+    {
+        // r = b - A * x é o primeiro vetor da base
+        SparseMultiplyVector(matrix, x, w);
+
+        for (int i = 0; i < size; i++)
+            basis[i] = b[i] - w[i];
+
+        double beta = sqrt(KrylovDot(basis, basis, size));
+        residual = beta / norm;
+
+        if (iteration == 0)
+            RecordKrylovResidual(history, residual);
+
+        if (residual <= tolerance || iteration >= maxIterations || IsTaskCancelled(task))
+            break;
+
+        for (int i = 0; i < size; i++)
+            basis[i] /= beta;
+
+        memset(g, 0, (restart + 1) * sizeof(double));
+        g[0] = beta;
+
+        int steps = 0;
+
+        for (int j = 0; j < restart && iteration < maxIterations; j++)
+        {
+            double *current = basis + (size_t)j * size;
+            double *next = basis + (size_t)(j + 1) * size;
+
+            ApplyPreconditioner(preconditioner, current, z, size);
+            SparseMultiplyVector(matrix, z, next);
+
+            // Ortogonalização de Gram-Schmidt modificada
+            for (int i = 0; i <= j; i++)
+            {
+                double *vector = basis + (size_t)i * size;
+                double h = KrylovDot(next, vector, size);
+
+                hessenberg[i * restart + j] = h;
+
+                for (int k = 0; k < size; k++)
+                    next[k] -= h * vector[k];
+            }
+
+            double length = sqrt(KrylovDot(next, next, size));
+            hessenberg[(j + 1) * restart + j] = length;
+
+            if (length != 0)
+            {
+                for (int k = 0; k < size; k++)
+                    next[k] /= length;
+            }
+
+            // Rotações de Givens mantêm a Hessenberg triangular superior
+            for (int i = 0; i < j; i++)
+            {
+                double a = hessenberg[i * restart + j];
+                double c = hessenberg[(i + 1) * restart + j];
+
+                hessenberg[i * restart + j] = cosines[i] * a + sines[i] * c;
+                hessenberg[(i + 1) * restart + j] = -sines[i] * a + cosines[i] * c;
+            }
+
+            double a = hessenberg[j * restart + j];
+            double c = hessenberg[(j + 1) * restart + j];
+            double radius = sqrt(a * a + c * c);
+
+            cosines[j] = radius != 0 ? a / radius : 1;
+            sines[j] = radius != 0 ? c / radius : 0;
+
+            hessenberg[j * restart + j] = radius;
+            hessenberg[(j + 1) * restart + j] = 0;
+
+            g[j + 1] = -sines[j] * g[j];
+            g[j] = cosines[j] * g[j];
+
+            steps = j + 1;
+            iteration++;
+
+            residual = fabs(g[j + 1]) / norm;
+            RecordKrylovResidual(history, residual);
+
+            SetTaskProgress(task, (float)iteration / maxIterations);
+
+            if (residual <= tolerance || length == 0 || IsTaskCancelled(task))
+                break;
+        }
+
+        // Resolve o sistema triangular e atualiza x = x + M^-1 * V * y
+        for (int i = steps - 1; i >= 0; i--)
+        {
+            double value = g[i];
+
+            for (int k = i + 1; k < steps; k++)
+                value -= hessenberg[i * restart + k] * y[k];
+
+            y[i] = hessenberg[i * restart + i] != 0 ? value / hessenberg[i * restart + i] : 0;
+        }
+
+        memset(w, 0, size * sizeof(double));
+
+        for (int i = 0; i < steps; i++)
+        {
+            double *vector = basis + (size_t)i * size;
+
+            for (int k = 0; k < size; k++)
+                w[k] += y[i] * vector[k];
+        }
+
+        ApplyPreconditioner(preconditioner, w, z, size);
+
+        for (int k = 0; k < size; k++)
+            x[k] += z[k];
+
+        if (residual <= tolerance || steps == 0)
+            break;
+    }
+
+    history->converged = residual <= tolerance;
+
+    free(basis);
+    free(hessenberg);
+    free(cosines);
+    free(sines);
+    free(g);
+    free(y);
+    free(w);
+    free(z);
+}
+
+#endif
@@ -1,8 +1,15 @@
 /*********************************************************************
 // Matrix.h
-// Implementa��o da matriz e da l�gica principal do programa. Toda matriz
-// pode armazenar no m�ximo 9 linhas e 9 colunas. Seu determinante �
-// calculado automaticamente semore que ocorrerem altera��es e n�o possui
+// Implementa��o da matriz e da l�gica principal do programa. As células
+// são alocadas conforme as dimensões crescem, até MTX_MAX_SIZE linhas e
+// colunas, e são exibidas em uma janela com rolagem e zoom na qual apenas
+// as células visíveis são formatadas e desenhadas. Os valores e o que já
+// foi calculado sobre eles podem ser gravados no arquivo de sessão. As células
+// aceitam valores complexos (a+bi), e a matriz com alguma parte imaginária
+// passa a ser calculada pelas rotinas complexas, e a matriz de um
+// resultado exato exibe suas células como frações. Seu determinante �
+// calculado automaticamente semore que ocorrerem altera��es, em segundo
+// plano (o último valor continua exibido até o novo), e n�o possui
 // limita��o de tamanho.
 // *********************************************************************/
 
@@ -10,9 +17,22 @@
 #define MATRIX_H
 
 #include <limits.h>
+#include <math.h>
+#include "Heatmap.h"
+#include "History.h"
 #include "NumberBox.h"
+#include "Complex.h"
+#include "Modular.h"
+#include "Rational.h"
+#include "Structure.h"
+#include "Random.h"
+#include "Snapshot.h"
+#include "Worker.h"
 
-#define MTX_MAX_SIZE 9
+#define MTX_MAX_SIZE 1000
+
+// Maior dimensão gerada pelo botão de valores aleatórios
+#define MTX_RANDOM_SIZE 9
 
 #define MTX_SPACING 8
 
@@ -23,6 +43,106 @@
 
 #define MTX_DIM_SEPARATOR " x "
 
+// Teclas de navegação entre as células (as especiais chegam somadas de 100)
+#define MTX_KEY_TAB 9
+#define MTX_KEY_LEFT 200
+#define MTX_KEY_UP 201
+#define MTX_KEY_RIGHT 202
+#define MTX_KEY_DOWN 203
+
+#define MTX_DETERMINANT_DIGITS 256
+
+// Seções do arquivo de sessão de cada matriz, cuja chave é a letra da matriz
+#define MTX_SNAPSHOT_INFO 1
+#define MTX_SNAPSHOT_VALUES 2
+#define MTX_SNAPSHOT_IMAGINARY 3
+#define MTX_SNAPSHOT_FRACTIONS 4
+
+#define MTX_SCROLLBAR_SIZE 8
+#define MTX_SCROLLBAR_MIN_THUMB 16
+
+// Distância (na tela) percorrida por um passo da roda do mouse
+#define MTX_WHEEL_STEP 40
+
+#define MTX_MIN_ZOOM 0.05f
+#define MTX_MAX_ZOOM 4.0f
+#define MTX_ZOOM_STEP 1.25f
+
+// Abaixo desta escala o texto (de tamanho fixo) não cabe nas células, que viram um mapa de calor
+#define MTX_TEXT_ZOOM 1.0f
+
+// Barra de rolagem sendo arrastada com o mouse
+#define MTX_DRAG_NONE 0
+#define MTX_DRAG_HORIZONTAL 1
+#define MTX_DRAG_VERTICAL 2
+
+// Posições das células, refeitas apenas quando um valor ou uma dimensão mudam
+typedef struct
+{
+    bool outdated;
+
+    // Alocados para todas as colunas reservadas
+    float *columnWidths;
+
+    // Distância horizontal do início do conteúdo até cada coluna (columns + 1 posições)
+    float *columnOffsets;
+
+    // Tamanho de todas as células, sem zoom
+    float contentWidth, contentHeight;
+} MatrixLayout;
+
+// Janela pela qual as células são vistas
+typedef struct
+{
+    // Maior tamanho ocupado pelas células na tela
+    float maxWidth, maxHeight;
+
+    // Posição do conteúdo (sem zoom) exibida no canto superior esquerdo da janela
+    float scrollX, scrollY;
+    float zoom;
+
+    // Tamanho da janela na tela e barras de rolagem exibidas, refeitos em UpdateMatrixView
+    float width, height;
+    bool horizontal, vertical;
+
+    // Cabeçalhos fixos com os índices das linhas e das colunas, exibidos quando há rolagem
+    float headerWidth, headerHeight;
+
+    // Barra sendo arrastada e distância do mouse até o início do seu cursor
+    int dragging;
+    float dragOffset;
+} MatrixView;
+
+// Dimensões e valores já calculados de uma matriz no arquivo de sessão
+typedef struct
+{
+    int32_t rows, columns;
+
+    int32_t structureFlags, structureLower, structureUpper;
+
+    int32_t exact, hasExactDeterminant;
+
+    // Matrizes complexas gravam também a seção MTX_SNAPSHOT_IMAGINARY
+    int32_t complex;
+
+    double determinant, imaginaryDeterminant;
+    char exactDeterminant[MTX_DETERMINANT_DIGITS];
+} MatrixSnapshot;
+
+// Cálculo da estrutura e do determinante sobre uma cópia dos valores, feito em segundo plano
+typedef struct
+{
+    int rows, columns;
+    double *elements, *imaginary;
+    bool complex, exact;
+
+    Structure structure;
+    double determinant, imaginaryDeterminant;
+
+    bool hasExactDeterminant;
+    char exactDeterminant[MTX_DETERMINANT_DIGITS];
+} MatrixProperties;
+
 typedef struct
 {
     char letter;
@@ -31,33 +151,211 @@ typedef struct
     bool changed;
 
     double determinant;
+    Structure structure;
+
+    // Verdadeiro caso alguma célula tenha parte imaginária (e então o determinante é complexo)
+    bool complex;
+    double imaginaryDeterminant;
+
+    bool exact, hasExactDeterminant;
+    char exactDeterminant[MTX_DETERMINANT_DIGITS];
+
+    // Calcula a estrutura e o determinante; os últimos valores continuam exibidos até o novo resultado
+    Worker worker;
 
     NumberBox rows, columns;
-    NumberBox boxes[MTX_MAX_SIZE][MTX_MAX_SIZE];
+
+    // Células linha por linha, com capacityColumns células por linha
+    NumberBox *boxes;
+    int capacityRows, capacityColumns;
+
+    // Configuração das células criadas ao reservar mais espaço
+    bool locked;
+    char format[10];
+
+    MatrixLayout layout;
+    MatrixView view;
+
+    // Pirâmide dos valores para o desenho com zoom reduzido
+    Heatmap heatmap;
+
+    // Intervalo (linha por linha) alterado desde o último registro no histórico (vazio se first > last)
+    int editFirst, editLast;
+
+    // Célula sob o mouse (-1 caso nenhuma)
+    int hoveredI, hoveredJ;
+
+    // Caixa que recebe o teclado (NULL caso nenhuma) e sua célula (-1 para as dimensões)
+    NumberBox *focused;
+    int focusedI, focusedJ;
 } Matrix;
 
-// Inicializa a matriz
+// Retorna a caixa da célula em tal linha e em tal coluna
+NumberBox *MatrixBox(Matrix *matrix, int i, int j)
+{
+    return &matrix->boxes[i * matrix->capacityColumns + j];
+}
+
+// Garante espaço para as células de tal número de linhas e de colunas
+// Os valores existentes são mantidos e as novas células começam com zero
+void ReserveMatrix(Matrix *matrix, int rows, int columns)
+{
+    if (rows <= matrix->capacityRows && columns <= matrix->capacityColumns)
+        return;
+
+    // O crescimento em dobro evita uma nova cópia a cada linha ou coluna adicionada
+    int capacityRows = matrix->capacityRows;
+    int capacityColumns = matrix->capacityColumns;
+
+    if (rows > capacityRows)
+        capacityRows = rows > 2 * capacityRows ? rows : 2 * capacityRows;
+
+    if (columns > capacityColumns)
+        capacityColumns = columns > 2 * capacityColumns ? columns : 2 * capacityColumns;
+
+    if (capacityRows > MTX_MAX_SIZE)
+        capacityRows = MTX_MAX_SIZE;
+
+    if (capacityColumns > MTX_MAX_SIZE)
+        capacityColumns = MTX_MAX_SIZE;
+
+    NumberBox *boxes = (NumberBox *)malloc((size_t)capacityRows * capacityColumns * sizeof(NumberBox));
+
+    for (int i = 0; i < capacityRows; i++)
+    {
+        for (int j = 0; j < capacityColumns; j++)
+        {
+            NumberBox *box = &boxes[i * capacityColumns + j];
+
+            if (i < matrix->capacityRows && j < matrix->capacityColumns)
+            {
+                *box = *MatrixBox(matrix, i, j);
+            }
+            else
+            {
+                InitializeNumberBox(box, 0, INT_MIN, INT_MAX, matrix->locked, matrix->format);
+                box->complex = true;
+            }
+        }
+    }
+
+    free(matrix->boxes);
+
+    matrix->boxes = boxes;
+    matrix->capacityRows = capacityRows;
+    matrix->capacityColumns = capacityColumns;
+
+    matrix->layout.columnWidths = (float *)realloc(matrix->layout.columnWidths, capacityColumns * sizeof(float));
+    matrix->layout.columnOffsets = (float *)realloc(matrix->layout.columnOffsets, (capacityColumns + 1) * sizeof(float));
+    matrix->layout.outdated = true;
+
+    // O foco apontava para a célula no espaço anterior
+    if (matrix->focusedI != -1)
+        matrix->focused = MatrixBox(matrix, matrix->focusedI, matrix->focusedJ);
+}
+
+// Calcula a estrutura e, para matrizes quadradas, o determinante da cópia dos valores
+void ExecuteMatrixProperties(void *work, Task *task)
+{
+    MatrixProperties *properties = (MatrixProperties *)work;
+
+    int size = properties->rows;
+
+    // A estrutura descreve a parte real, usada apenas pelos cálculos reais
+    DetectStructure(properties->elements, properties->rows, properties->columns, &properties->structure);
+
+    properties->determinant = 0;
+    properties->imaginaryDeterminant = 0;
+    properties->hasExactDeterminant = false;
+
+    if (properties->rows != properties->columns || IsTaskCancelled(task))
+        return;
+
+    if (properties->complex)
+        ComplexDeterminant(properties->elements, properties->imaginary, size, &properties->determinant, &properties->imaginaryDeterminant);
+    else
+        properties->determinant = StructuredDeterminant(properties->elements, size, &properties->structure);
+
+    if (properties->exact && !properties->complex && !IsTaskCancelled(task))
+    {
+        properties->hasExactDeterminant = CalculateExactDeterminant(
+            properties->elements,
+            size,
+            properties->exactDeterminant,
+            MTX_DETERMINANT_DIGITS);
+    }
+}
+
+// Libera o cálculo da estrutura e do determinante
+void FreeMatrixProperties(void *work)
+{
+    MatrixProperties *properties = (MatrixProperties *)work;
+
+    free(properties->elements);
+    free(properties->imaginary);
+    free(properties);
+}
+
+// Inicializa a matriz e a thread que calcula a sua estrutura e o seu determinante
 void InitializeMatrix(Matrix *matrix, char letter, int rows, int columns, bool locked, const char *format)
 {
     matrix->letter = letter;
     matrix->changed = true;
 
+    matrix->exact = false;
+    matrix->hasExactDeterminant = false;
+
+    matrix->complex = false;
+    matrix->imaginaryDeterminant = 0;
+
+    matrix->layout.outdated = true;
+    matrix->layout.columnWidths = NULL;
+    matrix->layout.columnOffsets = NULL;
+
+    matrix->view.maxWidth = INFINITY;
+    matrix->view.maxHeight = INFINITY;
+    matrix->view.scrollX = 0;
+    matrix->view.scrollY = 0;
+    matrix->view.zoom = 1;
+    matrix->view.dragging = MTX_DRAG_NONE;
+
+    InitializeHeatmap(&matrix->heatmap);
+
+    matrix->editFirst = 0;
+    matrix->editLast = INT_MAX;
+
+    matrix->hoveredI = -1;
+    matrix->hoveredJ = -1;
+
+    matrix->focused = NULL;
+    matrix->focusedI = -1;
+    matrix->focusedJ = -1;
+
     InitializeNumberBox(&matrix->rows, rows, 0, MTX_MAX_SIZE, locked, "%.0f");
     InitializeNumberBox(&matrix->columns, columns, 0, MTX_MAX_SIZE, locked, "%.0f");
 
-    for (int i = 0; i < MTX_MAX_SIZE; i++)
-    {
-        for (int j = 0; j < MTX_MAX_SIZE; j++)
-        {
-            InitializeNumberBox(&matrix->boxes[i][j], 0, INT_MIN, INT_MAX, locked, format);
-        }
-    }
+    matrix->locked = locked;
+    strcpy(matrix->format, format);
+
+    matrix->boxes = NULL;
+    matrix->capacityRows = 0;
+    matrix->capacityColumns = 0;
+
+    ReserveMatrix(matrix, rows > MTX_RANDOM_SIZE ? rows : MTX_RANDOM_SIZE, columns > MTX_RANDOM_SIZE ? columns : MTX_RANDOM_SIZE);
+
+    StartWorker(&matrix->worker, ExecuteMatrixProperties, FreeMatrixProperties);
 }
 
 // Retorna o valor armazenado em tal linha e em tal coluna da matriz
 double MatrixValue(Matrix *matrix, int i, int j)
 {
-    return matrix->boxes[i][j].value;
+    return MatrixBox(matrix, i, j)->value;
+}
+
+// Retorna a parte imaginária do valor em tal linha e em tal coluna da matriz
+double MatrixImaginary(Matrix *matrix, int i, int j)
+{
+    return MatrixBox(matrix, i, j)->imaginary;
 }
 
 // Retorna o n�mero de linhas da matriz
@@ -72,13 +370,55 @@ int MatrixColumns(Matrix *matrix)
     return (int)matrix->columns.value;
 }
 
+// Acrescenta um intervalo de posições (linha por linha) aos valores alterados desde o último registro
+void MarkMatrixEdited(Matrix *matrix, int first, int last)
+{
+    if (matrix->editFirst > matrix->editLast)
+    {
+        matrix->editFirst = first;
+        matrix->editLast = last;
+        return;
+    }
+
+    if (first < matrix->editFirst)
+        matrix->editFirst = first;
+
+    if (last > matrix->editLast)
+        matrix->editLast = last;
+}
+
+// Verifica se a matriz foi alterada desde o último registro no histórico
+bool IsMatrixEdited(Matrix *matrix)
+{
+    return matrix->editFirst <= matrix->editLast;
+}
+
 // Define o valor armazenado em tal linha e em tal coluna da matriz
 void SetMatrixValue(Matrix *matrix, int i, int j, double value)
 {
     if (MatrixValue(matrix, i, j) != value)
     {
         matrix->changed = true;
-        matrix->boxes[i][j].value = value;
+        matrix->layout.outdated = true;
+        SetNumberBoxValue(MatrixBox(matrix, i, j), value);
+        SetHeatmapValue(&matrix->heatmap, i, j, value);
+
+        int position = i * MatrixColumns(matrix) + j;
+        MarkMatrixEdited(matrix, position, position);
+    }
+}
+
+// Define a parte imaginária do valor em tal linha e em tal coluna da matriz
+void SetMatrixImaginary(Matrix *matrix, int i, int j, double imaginary)
+{
+    if (MatrixImaginary(matrix, i, j) != imaginary)
+    {
+        matrix->changed = true;
+        matrix->layout.outdated = true;
+        SetNumberBoxImaginary(MatrixBox(matrix, i, j), imaginary);
+
+        int position = i * MatrixColumns(matrix) + j;
+        MarkMatrixEdited(matrix, position, position);
     }
 }
 
@@ -87,8 +427,13 @@ void SetMatrixRows(Matrix *matrix, int rows)
 {
     if (MatrixRows(matrix) != rows)
     {
+        ReserveMatrix(matrix, rows, MatrixColumns(matrix));
+
         matrix->changed = true;
-        matrix->rows.value = rows;
+        matrix->layout.outdated = true;
+        SetNumberBoxValue(&matrix->rows, rows);
+
+        MarkMatrixEdited(matrix, 0, INT_MAX);
     }
 }
 
@@ -97,211 +442,903 @@ void SetMatrixColumns(Matrix *matrix, int columns)
 {
     if (MatrixColumns(matrix) != columns)
     {
+        ReserveMatrix(matrix, MatrixRows(matrix), columns);
+
         matrix->changed = true;
-        matrix->columns.value = columns;
+        matrix->layout.outdated = true;
+        SetNumberBoxValue(&matrix->columns, columns);
+
+        MarkMatrixEdited(matrix, 0, INT_MAX);
     }
 }
 
-// Define valores aleat�rios de -10 at� 10 para a matriz
-void RandomizeMatrix(Matrix *matrix)
+// Copia os elementos da matriz para um array linha por linha
+void GetMatrixElements(Matrix *matrix, double *elements)
 {
-    for (int i = 0; i < MTX_MAX_SIZE; i++)
+    int columns = MatrixColumns(matrix);
+
+    for (int i = 0; i < MatrixRows(matrix); i++)
     {
-        for (int j = 0; j < MTX_MAX_SIZE; j++)
+        for (int j = 0; j < columns; j++)
         {
-            SetMatrixValue(matrix, i, j, rand() % 21 - 10);
+            elements[i * columns + j] = MatrixValue(matrix, i, j);
         }
     }
 }
 
-// Calcula a largura de uma coluna da matriz
-float MatrixColumnWidth(Matrix *matrix, int j)
+// Copia as partes imaginárias dos elementos da matriz para um array linha por linha
+void GetMatrixImaginary(Matrix *matrix, double *elements)
 {
-    float columnWidth = 0;
+    int columns = MatrixColumns(matrix);
 
     for (int i = 0; i < MatrixRows(matrix); i++)
     {
-        float width = NumberBoxWidth(&matrix->boxes[i][j]);
-
-        if (width > columnWidth)
-            columnWidth = width;
+        for (int j = 0; j < columns; j++)
+        {
+            elements[i * columns + j] = MatrixImaginary(matrix, i, j);
+        }
     }
-
-    return columnWidth;
 }
 
-// Calcula a largura total da matriz
-float MatrixWidth(Matrix *matrix)
+// Define as dimensões e os elementos da matriz a partir de um array linha por linha
+// As partes imaginárias vêm de outro array, ou são zeradas caso imaginary seja NULL
+void SetMatrixElements(Matrix *matrix, const double *elements, int rows, int columns, const double *imaginary = NULL)
 {
-    float width = MTX_SPACING;
+    SetMatrixRows(matrix, rows);
+    SetMatrixColumns(matrix, columns);
 
-    for (int j = 0; j < MatrixColumns(matrix); j++)
+    for (int i = 0; i < rows; i++)
     {
-        width += MatrixColumnWidth(matrix, j);
-        width += MTX_SPACING;
+        for (int j = 0; j < columns; j++)
+        {
+            SetMatrixValue(matrix, i, j, elements[i * columns + j]);
+            SetMatrixImaginary(matrix, i, j, imaginary != NULL ? imaginary[i * columns + j] : 0);
+        }
     }
+}
 
-    width += 2 * MTX_SPACING;
-    width += NumberBoxWidth(&matrix->rows);
-    width += TextLength(MTX_DIM_SEPARATOR);
-    width += NumberBoxWidth(&matrix->columns);
+// Exibe as células como as frações de um array linha por linha (com as dimensões atuais da matriz)
+// Frações de denominador zero, ou fractions NULL, voltam a exibir o valor
+void SetMatrixFractions(Matrix *matrix, const Fraction *fractions)
+{
+    int columns = MatrixColumns(matrix);
 
-    return width;
+    for (int i = 0; i < MatrixRows(matrix); i++)
+    {
+        for (int j = 0; j < columns; j++)
+        {
+            NumberBox *box = MatrixBox(matrix, i, j);
+
+            if (fractions != NULL)
+                SetNumberBoxFraction(box, fractions[i * columns + j].numerator, fractions[i * columns + j].denominator);
+            else
+                SetNumberBoxFraction(box, 0, 0);
+
+            matrix->layout.outdated = matrix->layout.outdated || box->outdated;
+        }
+    }
 }
 
-// Calcula a altura total da matriz
-float MatrixHeight(Matrix *matrix)
+// Copia as frações exibidas pelas células para um array linha por linha
+// Retorna falso caso nenhuma célula exiba uma fração
+bool GetMatrixFractions(Matrix *matrix, Fraction *fractions)
 {
-    return FONT_SIZE + (2 + MatrixRows(matrix)) * NumberBoxHeight();
+    int columns = MatrixColumns(matrix);
+    bool found = false;
+
+    for (int i = 0; i < MatrixRows(matrix); i++)
+    {
+        for (int j = 0; j < columns; j++)
+        {
+            NumberBox *box = MatrixBox(matrix, i, j);
+
+            fractions[i * columns + j].numerator = box->numerator;
+            fractions[i * columns + j].denominator = box->denominator;
+
+            found = found || box->denominator != 0;
+        }
+    }
+
+    return found;
 }
 
-// Verifica se a matriz possui determinant (ou seja, quadrada)
-bool HasDeterminant(Matrix *matrix)
+// Define se o determinante da matriz deve ser calculado de forma exata
+void SetMatrixExact(Matrix *matrix, bool exact)
 {
-    return MatrixRows(matrix) == MatrixColumns(matrix);
+    if (matrix->exact != exact)
+    {
+        matrix->changed = true;
+        matrix->exact = exact;
+    }
 }
 
-// Calcula o determinante de um array bidimensional de inteiros de qualquer ordem
-double CalculateMatrixDeterminant(double elements[MTX_MAX_SIZE][MTX_MAX_SIZE], int size)
+// Define valores aleat�rios de -10 at� 10 para a matriz
+void RandomizeMatrix(Matrix *matrix)
 {
-    if (size == 1)
-        return elements[0][0];
+    double values[MTX_RANDOM_SIZE * MTX_RANDOM_SIZE];
 
-    double minor[MTX_MAX_SIZE][MTX_MAX_SIZE];
+    FillRandomIntegers(&globalRandom, values, MTX_RANDOM_SIZE * MTX_RANDOM_SIZE, -10, 10);
 
-    double determinant = 0;
-    double signal = 1;
+    ReserveMatrix(matrix, MTX_RANDOM_SIZE, MTX_RANDOM_SIZE);
 
-    for (int expansionJ = 0; expansionJ < size; expansionJ++)
+    for (int i = 0; i < MTX_RANDOM_SIZE; i++)
     {
-        for (int i = 1; i < size; i++)
+        for (int j = 0; j < MTX_RANDOM_SIZE; j++)
         {
-            for (int j = 0; j < expansionJ; j++)
-                minor[i - 1][j] = elements[i][j];
-
-            for (int j = expansionJ + 1; j < size; j++)
-                minor[i - 1][j - 1] = elements[i][j];
+            SetMatrixValue(matrix, i, j, values[i * MTX_RANDOM_SIZE + j]);
+            SetMatrixImaginary(matrix, i, j, 0);
         }
-
-        double cofactor = signal * elements[0][expansionJ];
-        double minorDeterminant = CalculateMatrixDeterminant(minor, size - 1);
-
-        double term = cofactor * minorDeterminant;
-
-        determinant += term;
-        signal *= -1;
     }
+}
 
-    return determinant;
+// Calcula a distância vertical entre o topo de duas linhas consecutivas
+float MatrixRowPitch()
+{
+    return NumberBoxHeight() + MTX_SPACING;
 }
 
-// Atualiza o determinante da matriz
-void UpdateMatrix(Matrix *matrix)
+// Recalcula as larguras das colunas e as posições dos elementos, caso necessário
+void UpdateMatrixLayout(Matrix *matrix)
 {
-    if (!matrix->changed)
+    MatrixLayout *layout = &matrix->layout;
+
+    if (!layout->outdated)
         return;
 
-    matrix->changed = false;
+    layout->outdated = false;
 
-    if (HasDeterminant(matrix))
-    {
-        double elements[MTX_MAX_SIZE][MTX_MAX_SIZE];
-        int size = MatrixRows(matrix);
+    int rows = MatrixRows(matrix);
+    int columns = MatrixColumns(matrix);
+
+    for (int j = 0; j < columns; j++)
+        layout->columnWidths[j] = 0;
 
-        for (int i = 0; i < size; i++)
+    // Percorre as células na ordem em que estão na memória
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < columns; j++)
         {
-            for (int j = 0; j < size; j++)
-            {
-                elements[i][j] = MatrixValue(matrix, i, j);
-            }
+            float width = NumberBoxWidth(MatrixBox(matrix, i, j));
+
+            if (width > layout->columnWidths[j])
+                layout->columnWidths[j] = width;
         }
+    }
+
+    layout->columnOffsets[0] = 0;
 
-        matrix->determinant = CalculateMatrixDeterminant(elements, size);
+    for (int j = 0; j < columns; j++)
+    {
+        layout->columnOffsets[j + 1] = layout->columnOffsets[j] + layout->columnWidths[j] + MTX_SPACING;
     }
+
+    layout->contentWidth = columns > 0 ? layout->columnOffsets[columns] - MTX_SPACING : 0;
+    layout->contentHeight = rows > 0 ? rows * MatrixRowPitch() - MTX_SPACING : 0;
 }
 
-// Real�a uma posi��o at� outra posi��o da matriz
-void HighlightMatrix(Matrix *matrix, int fromI, int fromJ, int toI, int toJ)
+// Atualiza o layout após a edição da célula (i, j): apenas a largura da coluna j e as
+// posições das colunas seguintes mudam. A coluna só é percorrida quando a célula encolhe,
+// pois ela podia ser a mais larga
+void UpdateMatrixCellLayout(Matrix *matrix, int i, int j)
 {
-    float boxHeight = NumberBoxHeight();
+    MatrixLayout *layout = &matrix->layout;
+
+    // Um recálculo completo pendente já inclui a célula
+    if (layout->outdated)
+        return;
 
-    float boxX = matrix->x + MTX_SPACING;
-    float boxY = matrix->y - FONT_SIZE;
+    int rows = MatrixRows(matrix);
+    int columns = MatrixColumns(matrix);
 
-    float startX = boxX;
-    float startY = boxY - (boxHeight + MTX_SPACING) * (MatrixRows(matrix) - fromI);
+    float width = NumberBoxWidth(MatrixBox(matrix, i, j));
 
-    for (int j = 0; j < fromJ; j++)
+    if (width < layout->columnWidths[j])
     {
-        startX += MatrixColumnWidth(matrix, j);
-        startX += MTX_SPACING;
+        for (int k = 0; k < rows; k++)
+        {
+            float other = NumberBoxWidth(MatrixBox(matrix, k, j));
+
+            if (other > width)
+                width = other;
+        }
     }
 
-    float endX = startX + MatrixColumnWidth(matrix, fromJ);
-    float endY = startY + boxHeight + (boxHeight + MTX_SPACING) * (toI - fromI);
+    if (width == layout->columnWidths[j])
+        return;
+
+    layout->columnWidths[j] = width;
 
-    for (int j = fromJ + 1; j <= toJ; j++)
+    for (int k = j; k < columns; k++)
     {
-        endX += MatrixColumnWidth(matrix, j);
-        endX += MTX_SPACING;
+        layout->columnOffsets[k + 1] = layout->columnOffsets[k] + layout->columnWidths[k] + MTX_SPACING;
     }
 
-    CV::rectFill(
-        startX - MTX_HIGHLIGHT_PADDING,
-        startY - MTX_HIGHLIGHT_PADDING,
-        endX + MTX_HIGHLIGHT_PADDING,
-        endY + MTX_HIGHLIGHT_PADDING);
+    layout->contentWidth = layout->columnOffsets[columns] - MTX_SPACING;
 }
 
-// Desenha a matriz
-void DrawMatrix(Matrix *matrix)
+// Recalcula o tamanho da janela, as barras de rolagem e os cabeçalhos, mantendo a rolagem dentro do conteúdo
+void UpdateMatrixView(Matrix *matrix)
 {
-    float x = matrix->x;
-    float y = matrix->y;
+    UpdateMatrixLayout(matrix);
 
-    char determinantText[TEXT_BUFFER_SIZE];
+    MatrixLayout *layout = &matrix->layout;
+    MatrixView *view = &matrix->view;
+
+    float zoomedWidth = layout->contentWidth * view->zoom;
+    float zoomedHeight = layout->contentHeight * view->zoom;
+
+    view->horizontal = zoomedWidth > view->maxWidth;
+    view->vertical = zoomedHeight > view->maxHeight;
 
-    if (HasDeterminant(matrix))
+    view->width = view->horizontal ? view->maxWidth : zoomedWidth;
+    view->height = view->vertical ? view->maxHeight : zoomedHeight;
+
+    float maxScrollX = fmaxf(0, layout->contentWidth - view->width / view->zoom);
+    float maxScrollY = fmaxf(0, layout->contentHeight - view->height / view->zoom);
+
+    view->scrollX = fminf(fmaxf(view->scrollX, 0), maxScrollX);
+    view->scrollY = fminf(fmaxf(view->scrollY, 0), maxScrollY);
+
+    if (view->horizontal || view->vertical)
     {
-        sprintf(determinantText, "det(%c) = %.2f", matrix->letter, matrix->determinant);
+        char text[16];
+        sprintf(text, "%d", MatrixRows(matrix));
+
+        view->headerWidth = TextLength(text) + MTX_SPACING;
+        view->headerHeight = FONT_SIZE + MTX_SPACING;
     }
     else
     {
-        sprintf(determinantText, "det(%c) = ERROR", matrix->letter);
+        view->headerWidth = 0;
+        view->headerHeight = 0;
     }
+}
 
-    Color8(0, 0, 0);
-    CV::text(x, y, determinantText);
-    y -= FONT_SIZE;
+// Define o maior tamanho ocupado pelas células na tela
+void SetMatrixViewSize(Matrix *matrix, float maxWidth, float maxHeight)
+{
+    matrix->view.maxWidth = fmaxf(maxWidth, 0);
+    matrix->view.maxHeight = fmaxf(maxHeight, 0);
+}
 
-    float boxHeight = NumberBoxHeight();
+// Posição na tela da borda esquerda da janela das células
+float MatrixViewLeft(Matrix *matrix)
+{
+    return matrix->x + MTX_SPACING + matrix->view.headerWidth;
+}
 
-    float boxX = x + MTX_SPACING;
-    float boxY = y - MTX_SPACING;
+// Posição na tela do topo da janela das células
+float MatrixViewTop(Matrix *matrix)
+{
+    float bottom = matrix->y - FONT_SIZE - MTX_SPACING;
 
-    for (int j = 0; j < MatrixColumns(matrix); j++)
-    {
-        float columnWidth = MatrixColumnWidth(matrix, j);
+    if (matrix->view.horizontal)
+        bottom -= MTX_SCROLLBAR_SIZE + MTX_SPACING;
 
-        boxY = y - MTX_SPACING;
+    return bottom - matrix->view.height;
+}
 
-        for (int i = MatrixRows(matrix) - 1; i >= 0; i--)
-        {
-            float boxWidth = NumberBoxWidth(&matrix->boxes[i][j]);
+// Posição na tela da borda esquerda da coluna j
+float MatrixColumnX(Matrix *matrix, int j)
+{
+    return MatrixViewLeft(matrix) + (matrix->layout.columnOffsets[j] - matrix->view.scrollX) * matrix->view.zoom;
+}
 
-            matrix->boxes[i][j].x = boxX + (columnWidth - boxWidth) / 2;
-            matrix->boxes[i][j].y = boxY;
+// Posição na tela do topo da linha i
+float MatrixRowY(Matrix *matrix, int i)
+{
+    return MatrixViewTop(matrix) + (i * MatrixRowPitch() - matrix->view.scrollY) * matrix->view.zoom;
+}
 
-            DrawNumberBox(&matrix->boxes[i][j]);
+// Posição na tela do colchete direito
+float MatrixBracketX(Matrix *matrix)
+{
+    float x = MatrixViewLeft(matrix) + matrix->view.width + MTX_SPACING;
 
-            boxY -= boxHeight + MTX_SPACING;
-        }
+    if (matrix->view.vertical)
+        x += MTX_SCROLLBAR_SIZE + MTX_SPACING;
 
-        boxX += columnWidth;
-        boxX += MTX_SPACING;
-    }
+    return x;
+}
 
-    Color8(0, 0, 0);
+// Calcula a largura de uma coluna da matriz
+float MatrixColumnWidth(Matrix *matrix, int j)
+{
+    UpdateMatrixLayout(matrix);
+
+    return matrix->layout.columnWidths[j];
+}
+
+// Calcula a largura de todas as células com o zoom atual, sem o limite da janela
+float MatrixContentWidth(Matrix *matrix)
+{
+    UpdateMatrixLayout(matrix);
+
+    return matrix->layout.contentWidth * matrix->view.zoom;
+}
+
+// Calcula a largura total da matriz
+float MatrixWidth(Matrix *matrix)
+{
+    UpdateMatrixView(matrix);
+
+    float width = MatrixBracketX(matrix) - matrix->x;
+
+    width += 2 * MTX_SPACING;
+    width += NumberBoxWidth(&matrix->rows);
+    width += TextLength(MTX_DIM_SEPARATOR);
+    width += NumberBoxWidth(&matrix->columns);
+
+    return width;
+}
+
+// Calcula a altura total da matriz
+float MatrixHeight(Matrix *matrix)
+{
+    UpdateMatrixView(matrix);
+
+    return matrix->y - MatrixViewTop(matrix) + matrix->view.headerHeight + 2 * MTX_SPACING + FONT_SIZE;
+}
+
+// Verifica se a matriz possui determinant (ou seja, quadrada)
+bool HasDeterminant(Matrix *matrix)
+{
+    return MatrixRows(matrix) == MatrixColumns(matrix);
+}
+
+// Calcula o determinante de um array de qualquer ordem (linha por linha) por expansão em cofatores
+double CalculateMatrixDeterminant(const double *elements, int size)
+{
+    if (size == 1)
+        return elements[0];
+
+    int minorSize = size - 1;
+    double *minor = (double *)malloc(minorSize * minorSize * sizeof(double));
+
+    double determinant = 0;
+    double signal = 1;
+
+    for (int expansionJ = 0; expansionJ < size; expansionJ++)
+    {
+        for (int i = 1; i < size; i++)
+        {
+            for (int j = 0; j < expansionJ; j++)
+                minor[(i - 1) * minorSize + j] = elements[i * size + j];
+
+            for (int j = expansionJ + 1; j < size; j++)
+                minor[(i - 1) * minorSize + j - 1] = elements[i * size + j];
+        }
+
+        double cofactor = signal * elements[expansionJ];
+        double minorDeterminant = CalculateMatrixDeterminant(minor, minorSize);
+
+        double term = cofactor * minorDeterminant;
+
+        determinant += term;
+        signal *= -1;
+    }
+
+    free(minor);
+
+    return determinant;
+}
+
+// Aplica à matriz a estrutura e o determinante do último cálculo concluído, caso exista
+void ReceiveMatrixProperties(Matrix *matrix)
+{
+    MatrixProperties *properties = (MatrixProperties *)TakeFinishedWork(&matrix->worker);
+
+    if (properties == NULL)
+        return;
+
+    matrix->structure = properties->structure;
+
+    matrix->determinant = properties->determinant;
+    matrix->imaginaryDeterminant = properties->imaginaryDeterminant;
+
+    matrix->hasExactDeterminant = properties->hasExactDeterminant;
+
+    if (properties->hasExactDeterminant)
+        memcpy(matrix->exactDeterminant, properties->exactDeterminant, MTX_DETERMINANT_DIGITS);
+
+    FreeMatrixProperties(properties);
+}
+
+// Envia ao segundo plano o cálculo da estrutura e do determinante caso a matriz tenha mudado,
+// e recebe o último cálculo concluído (a indicação de valores complexos é atualizada na hora)
+void UpdateMatrix(Matrix *matrix)
+{
+    if (matrix->changed)
+    {
+        matrix->changed = false;
+
+        size_t count = (size_t)MatrixRows(matrix) * MatrixColumns(matrix);
+
+        MatrixProperties *properties = (MatrixProperties *)malloc(sizeof(MatrixProperties));
+
+        properties->rows = MatrixRows(matrix);
+        properties->columns = MatrixColumns(matrix);
+        properties->elements = (double *)malloc((count + 1) * sizeof(double));
+        properties->imaginary = (double *)malloc((count + 1) * sizeof(double));
+
+        GetMatrixElements(matrix, properties->elements);
+        GetMatrixImaginary(matrix, properties->imaginary);
+
+        matrix->complex = false;
+
+        for (size_t k = 0; k < count && !matrix->complex; k++)
+            matrix->complex = properties->imaginary[k] != 0;
+
+        properties->complex = matrix->complex;
+        properties->exact = matrix->exact;
+
+        SubmitWork(&matrix->worker, properties);
+    }
+
+    ReceiveMatrixProperties(matrix);
+}
+
+// Aguarda o cálculo da estrutura e do determinante em andamento e o aplica à matriz
+void FinishMatrixUpdate(Matrix *matrix)
+{
+    UpdateMatrix(matrix);
+
+    WaitWorker(&matrix->worker);
+    ReceiveMatrixProperties(matrix);
+}
+
+// Encontra a última coluna que começa antes de tal distância do início do conteúdo (-1 caso nenhuma)
+int SearchMatrixColumn(Matrix *matrix, float distance)
+{
+    int j = -1;
+    int low = 0, high = MatrixColumns(matrix) - 1;
+
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+
+        if (matrix->layout.columnOffsets[middle] <= distance)
+        {
+            j = middle;
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+
+    return j;
+}
+
+// Calcula os intervalos (fechados) de linhas e de colunas que aparecem na janela
+void VisibleMatrixCells(Matrix *matrix, int *firstI, int *lastI, int *firstJ, int *lastJ)
+{
+    MatrixView *view = &matrix->view;
+
+    float pitch = MatrixRowPitch();
+
+    int first = SearchMatrixColumn(matrix, view->scrollX);
+    *firstJ = first > 0 ? first : 0;
+    *lastJ = SearchMatrixColumn(matrix, view->scrollX + view->width / view->zoom);
+
+    // As linhas têm a mesma altura e dispensam a busca
+    *firstI = (int)(view->scrollY / pitch);
+    *lastI = (int)((view->scrollY + view->height / view->zoom) / pitch);
+
+    if (*lastI > MatrixRows(matrix) - 1)
+        *lastI = MatrixRows(matrix) - 1;
+}
+
+// Encontra a célula sob a coordenada da tela, considerando a rolagem e o zoom
+// Retorna falso caso a coordenada não esteja sobre nenhuma célula visível
+bool FindMatrixCell(Matrix *matrix, int x, int y, int *cellI, int *cellJ)
+{
+    UpdateMatrixView(matrix);
+
+    MatrixLayout *layout = &matrix->layout;
+    MatrixView *view = &matrix->view;
+
+    float left = MatrixViewLeft(matrix);
+    float top = MatrixViewTop(matrix);
+
+    if (x < left || x > left + view->width || y < top || y > top + view->height)
+        return false;
+
+    float contentX = view->scrollX + (x - left) / view->zoom;
+    float contentY = view->scrollY + (y - top) / view->zoom;
+
+    float pitch = MatrixRowPitch();
+
+    int i = (int)(contentY / pitch);
+    int j = SearchMatrixColumn(matrix, contentX);
+
+    // A coordenada ainda pode estar no espaçamento entre as células
+    if (j == -1 || i >= MatrixRows(matrix))
+        return false;
+
+    if (contentX > layout->columnOffsets[j] + layout->columnWidths[j] || contentY - i * pitch > NumberBoxHeight())
+        return false;
+
+    *cellI = i;
+    *cellJ = j;
+
+    return true;
+}
+
+// Rola a janela até que a célula (i, j) fique inteiramente visível
+void ScrollToMatrixCell(Matrix *matrix, int i, int j)
+{
+    UpdateMatrixView(matrix);
+
+    MatrixLayout *layout = &matrix->layout;
+    MatrixView *view = &matrix->view;
+
+    float visibleWidth = view->width / view->zoom;
+    float visibleHeight = view->height / view->zoom;
+
+    float cellLeft = layout->columnOffsets[j];
+    float cellRight = cellLeft + layout->columnWidths[j];
+
+    float cellTop = i * MatrixRowPitch();
+    float cellBottom = cellTop + NumberBoxHeight();
+
+    if (cellRight > view->scrollX + visibleWidth)
+        view->scrollX = cellRight - visibleWidth;
+
+    if (cellLeft < view->scrollX)
+        view->scrollX = cellLeft;
+
+    if (cellBottom > view->scrollY + visibleHeight)
+        view->scrollY = cellBottom - visibleHeight;
+
+    if (cellTop < view->scrollY)
+        view->scrollY = cellTop;
+}
+
+// Real�a uma posi��o at� outra posi��o da matriz
+void HighlightMatrix(Matrix *matrix, int fromI, int fromJ, int toI, int toJ)
+{
+    UpdateMatrixView(matrix);
+
+    MatrixView *view = &matrix->view;
+
+    float startX = MatrixColumnX(matrix, fromJ);
+    float startY = MatrixRowY(matrix, fromI);
+
+    float endX = MatrixColumnX(matrix, toJ) + matrix->layout.columnWidths[toJ] * view->zoom;
+    float endY = MatrixRowY(matrix, toI) + NumberBoxHeight() * view->zoom;
+
+    float left = MatrixViewLeft(matrix);
+    float top = MatrixViewTop(matrix);
+
+    // O realce das células fora da janela não pode aparecer sobre os cabeçalhos
+    ClipRect(
+        left - MTX_HIGHLIGHT_PADDING,
+        top - MTX_HIGHLIGHT_PADDING,
+        left + view->width + MTX_HIGHLIGHT_PADDING,
+        top + view->height + MTX_HIGHLIGHT_PADDING);
+
+    CV::rectFill(
+        startX - MTX_HIGHLIGHT_PADDING,
+        startY - MTX_HIGHLIGHT_PADDING,
+        endX + MTX_HIGHLIGHT_PADDING,
+        endY + MTX_HIGHLIGHT_PADDING);
+
+    Unclip();
+}
+
+// Recria a pirâmide do mapa de calor caso as dimensões da matriz tenham mudado
+// Alterações de valores já chegam à pirâmide pelo SetMatrixValue
+void UpdateMatrixHeatmap(Matrix *matrix)
+{
+    Heatmap *heatmap = &matrix->heatmap;
+
+    int rows = MatrixRows(matrix);
+    int columns = MatrixColumns(matrix);
+
+    if (HeatmapRows(heatmap) == rows && HeatmapColumns(heatmap) == columns)
+        return;
+
+    ResizeHeatmap(heatmap, rows, columns);
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < columns; j++)
+            SetHeatmapValue(heatmap, i, j, MatrixValue(matrix, i, j));
+    }
+}
+
+// Desenha as células visíveis como mapa de calor, com um nível da pirâmide em uma textura
+// As colunas têm larguras diferentes, então a textura é esticada em uma única faixa de
+// quadriláteros cujos vértices caem nas bordas dos blocos visíveis
+void DrawMatrixHeatmap(Matrix *matrix, int firstJ, int lastJ)
+{
+    UpdateMatrixHeatmap(matrix);
+
+    Heatmap *heatmap = &matrix->heatmap;
+
+    if (heatmap->levels == 0)
+        return;
+
+    MatrixLayout *layout = &matrix->layout;
+    MatrixView *view = &matrix->view;
+
+    int rows = MatrixRows(matrix);
+    int columns = MatrixColumns(matrix);
+
+    float cellWidth = layout->contentWidth / columns * view->zoom;
+    float cellHeight = MatrixRowPitch() * view->zoom;
+
+    int l = ChooseHeatmapLevel(heatmap, cellWidth, cellHeight);
+    HeatmapLevel *level = &heatmap->level[l];
+
+    UpdateHeatmapTexture(heatmap, l);
+
+    // As linhas têm a mesma altura, então a textura vai da primeira à última na vertical
+    float top = MatrixRowY(matrix, 0);
+    float bottom = MatrixRowY(matrix, rows);
+
+    glEnable(GL_TEXTURE_2D);
+    glColor3f(1, 1, 1);
+
+    glBegin(GL_QUAD_STRIP);
+
+    for (int block = firstJ >> l; block <= (lastJ >> l) + 1 && block <= level->columns; block++)
+    {
+        int j = block << l;
+
+        if (j > columns)
+            j = columns;
+
+        float x = MatrixColumnX(matrix, j);
+        float u = (float)block / level->columns;
+
+        glTexCoord2f(u, 0);
+        glVertex2f(x, top);
+        glTexCoord2f(u, 1);
+        glVertex2f(x, bottom);
+    }
+
+    glEnd();
+
+    glDisable(GL_TEXTURE_2D);
+}
+
+// Desenha uma célula reduzida demais para o texto, apenas com a borda da caixa de número
+void DrawMatrixCell(NumberBox *box, float x, float y, float width, float height)
+{
+    Color8(200, 200, 200);
+
+    if (!box->locked)
+    {
+        if (box->hovering)
+            Color8(255, 199, 128);
+
+        if (box->focused)
+            Color8(255, 145, 3);
+    }
+
+    CV::rect(x, y, x + width, y + height);
+}
+
+// Desenha os índices das linhas e das colunas visíveis, fixos nas bordas da janela
+void DrawMatrixHeaders(Matrix *matrix, int firstI, int lastI, int firstJ, int lastJ)
+{
+    MatrixView *view = &matrix->view;
+
+    if (view->headerWidth == 0)
+        return;
+
+    float left = MatrixViewLeft(matrix);
+    float top = MatrixViewTop(matrix);
+
+    char text[16];
+
+    Color8(128, 128, 128);
+
+    ClipRect(left, top - view->headerHeight, left + view->width, top);
+
+    for (int j = firstJ; j <= lastJ; j++)
+    {
+        sprintf(text, "%d", j + 1);
+
+        float width = matrix->layout.columnWidths[j] * view->zoom;
+
+        // Índices mais largos do que a coluna se sobreporiam
+        if (TextLength(text) <= width)
+            CV::text(MatrixColumnX(matrix, j) + (width - TextLength(text)) / 2, top - MTX_SPACING / 2, text);
+    }
+
+    ClipRect(matrix->x, top, left, top + view->height);
+
+    float height = NumberBoxHeight() * view->zoom;
+
+    if (MatrixRowPitch() * view->zoom >= FONT_SIZE)
+    {
+        for (int i = firstI; i <= lastI; i++)
+        {
+            sprintf(text, "%d", i + 1);
+
+            CV::text(matrix->x + MTX_SPACING, MatrixRowY(matrix, i) + (height + FONT_SIZE) / 2, text);
+        }
+    }
+
+    Unclip();
+}
+
+// Calcula o início e o tamanho do cursor de uma barra de rolagem
+void MatrixScrollbarThumb(float length, float visible, float content, float scroll, float *start, float *size)
+{
+    *size = fmaxf(length * visible / content, MTX_SCROLLBAR_MIN_THUMB);
+
+    float range = content - visible;
+
+    *start = range > 0 ? (length - *size) * scroll / range : 0;
+}
+
+// Desenha uma barra de rolagem do ponto (x, y) com tal comprimento
+void DrawMatrixScrollbar(float x, float y, float length, float thumbStart, float thumbSize, bool horizontal, bool dragging)
+{
+    Color8(230, 230, 230);
+
+    if (horizontal)
+        CV::rectFill(x, y, x + length, y + MTX_SCROLLBAR_SIZE);
+    else
+        CV::rectFill(x, y, x + MTX_SCROLLBAR_SIZE, y + length);
+
+    if (dragging)
+        Color8(255, 145, 3);
+    else
+        Color8(180, 180, 180);
+
+    if (horizontal)
+        CV::rectFill(x + thumbStart, y, x + thumbStart + thumbSize, y + MTX_SCROLLBAR_SIZE);
+    else
+        CV::rectFill(x, y + thumbStart, x + MTX_SCROLLBAR_SIZE, y + thumbStart + thumbSize);
+}
+
+// Desenha as barras de rolagem da janela, caso o conteúdo não caiba nela
+void DrawMatrixScrollbars(Matrix *matrix)
+{
+    MatrixLayout *layout = &matrix->layout;
+    MatrixView *view = &matrix->view;
+
+    float left = MatrixViewLeft(matrix);
+    float top = MatrixViewTop(matrix);
+
+    float thumbStart, thumbSize;
+
+    if (view->horizontal)
+    {
+        MatrixScrollbarThumb(view->width, view->width / view->zoom, layout->contentWidth, view->scrollX, &thumbStart, &thumbSize);
+
+        DrawMatrixScrollbar(
+            left,
+            top + view->height + MTX_SPACING,
+            view->width,
+            thumbStart,
+            thumbSize,
+            true,
+            view->dragging == MTX_DRAG_HORIZONTAL);
+    }
+
+    if (view->vertical)
+    {
+        MatrixScrollbarThumb(view->height, view->height / view->zoom, layout->contentHeight, view->scrollY, &thumbStart, &thumbSize);
+
+        DrawMatrixScrollbar(
+            left + view->width + MTX_SPACING,
+            top,
+            view->height,
+            thumbStart,
+            thumbSize,
+            false,
+            view->dragging == MTX_DRAG_VERTICAL);
+    }
+}
+
+// Desenha a matriz
+void DrawMatrix(Matrix *matrix)
+{
+    float x = matrix->x;
+    float y = matrix->y;
+
+    char determinantText[TEXT_BUFFER_SIZE];
+
+    if (HasDeterminant(matrix) && matrix->hasExactDeterminant)
+    {
+        sprintf(determinantText, "det(%c) = %s", matrix->letter, matrix->exactDeterminant);
+    }
+    else if (HasDeterminant(matrix) && matrix->complex)
+    {
+        sprintf(determinantText, "det(%c) = %.2f%+.2fi", matrix->letter, matrix->determinant, matrix->imaginaryDeterminant);
+    }
+    else if (HasDeterminant(matrix))
+    {
+        sprintf(determinantText, "det(%c) = %.2f", matrix->letter, matrix->determinant);
+    }
+    else
+    {
+        sprintf(determinantText, "det(%c) = ERROR", matrix->letter);
+    }
+
+    Color8(0, 0, 0);
+    CV::text(x, y, determinantText);
+
+    UpdateMatrixView(matrix);
+
+    MatrixLayout *layout = &matrix->layout;
+    MatrixView *view = &matrix->view;
+
+    float left = MatrixViewLeft(matrix);
+    float top = MatrixViewTop(matrix);
+
+    float boxHeight = NumberBoxHeight();
+    float cellHeight = boxHeight * view->zoom;
+
+    int firstI, lastI, firstJ, lastJ;
+    VisibleMatrixCells(matrix, &firstI, &lastI, &firstJ, &lastJ);
+
+    // Apenas as células visíveis são formatadas e desenhadas, recortadas na borda da janela
+    ClipRect(left, top, left + view->width, top + view->height);
+
+    if (view->zoom >= MTX_TEXT_ZOOM)
+    {
+        for (int i = firstI; i <= lastI; i++)
+        {
+            float cellY = MatrixRowY(matrix, i);
+
+            for (int j = firstJ; j <= lastJ; j++)
+            {
+                NumberBox *box = MatrixBox(matrix, i, j);
+
+                float cellWidth = layout->columnWidths[j] * view->zoom;
+
+                // O texto tem tamanho fixo, então a caixa é centralizada na célula ampliada
+                box->x = MatrixColumnX(matrix, j) + (cellWidth - NumberBoxWidth(box)) / 2;
+                box->y = cellY + (cellHeight + boxHeight) / 2;
+
+                DrawNumberBox(box);
+            }
+        }
+    }
+    else
+    {
+        DrawMatrixHeatmap(matrix, firstJ, lastJ);
+
+        // Apenas as células sob o mouse e com o foco ainda recebem borda
+        int cellsI[2] = {matrix->hoveredI, matrix->focusedI};
+        int cellsJ[2] = {matrix->hoveredJ, matrix->focusedJ};
+
+        for (int k = 0; k < 2; k++)
+        {
+            int i = cellsI[k];
+            int j = cellsJ[k];
+
+            if (i >= 0 && i < MatrixRows(matrix) && j >= 0 && j < MatrixColumns(matrix))
+            {
+                DrawMatrixCell(
+                    MatrixBox(matrix, i, j),
+                    MatrixColumnX(matrix, j),
+                    MatrixRowY(matrix, i),
+                    layout->columnWidths[j] * view->zoom,
+                    cellHeight);
+            }
+        }
+    }
+
+    Unclip();
+
+    DrawMatrixHeaders(matrix, firstI, lastI, firstJ, lastJ);
+    DrawMatrixScrollbars(matrix);
+
+    float boxX = MatrixBracketX(matrix);
+    float boxY = top - view->headerHeight - MTX_SPACING;
+
+    y -= FONT_SIZE;
+
+    Color8(0, 0, 0);
 
     char labelText[3];
     sprintf(labelText, "%c:", matrix->letter);
@@ -337,34 +1374,498 @@ void DrawMatrix(Matrix *matrix)
     DrawNumberBox(&matrix->columns);
 }
 
+// Move o foco do teclado para a caixa (NULL remove o foco)
+// Caixas travadas não recebem o foco
+void SetMatrixFocus(Matrix *matrix, NumberBox *box, int i, int j)
+{
+    if (box != NULL && box->locked)
+        box = NULL;
+
+    if (matrix->focused != NULL)
+    {
+        matrix->focused->focused = false;
+
+        // A próxima edição da caixa volta a começar pela parte real
+        matrix->focused->imaginaryInput = false;
+        matrix->focused->outdated = true;
+
+        if (matrix->focusedI != -1 && matrix->focusedI < MatrixRows(matrix) && matrix->focusedJ < MatrixColumns(matrix))
+            UpdateMatrixCellLayout(matrix, matrix->focusedI, matrix->focusedJ);
+        else
+            matrix->layout.outdated = true;
+    }
+
+    matrix->focused = box;
+    matrix->focusedI = box != NULL ? i : -1;
+    matrix->focusedJ = box != NULL ? j : -1;
+
+    if (box != NULL)
+        box->focused = true;
+}
+
+// Move o foco para a célula (i, j), caso ela exista, e a traz para dentro da janela
+void FocusMatrixCell(Matrix *matrix, int i, int j)
+{
+    if (i >= 0 && i < MatrixRows(matrix) && j >= 0 && j < MatrixColumns(matrix))
+    {
+        SetMatrixFocus(matrix, MatrixBox(matrix, i, j), i, j);
+        ScrollToMatrixCell(matrix, i, j);
+    }
+}
+
+// Move o foco para a próxima caixa: as células linha por linha e depois as dimensões
+void FocusNextMatrixBox(Matrix *matrix)
+{
+    int rows = MatrixRows(matrix);
+    int columns = MatrixColumns(matrix);
+
+    if (matrix->focused == &matrix->rows)
+    {
+        SetMatrixFocus(matrix, &matrix->columns, -1, -1);
+    }
+    else if (matrix->focused == &matrix->columns)
+    {
+        if (rows > 0 && columns > 0)
+            FocusMatrixCell(matrix, 0, 0);
+        else
+            SetMatrixFocus(matrix, &matrix->rows, -1, -1);
+    }
+    else if (matrix->focusedJ + 1 < columns)
+    {
+        FocusMatrixCell(matrix, matrix->focusedI, matrix->focusedJ + 1);
+    }
+    else if (matrix->focusedI + 1 < rows)
+    {
+        FocusMatrixCell(matrix, matrix->focusedI + 1, 0);
+    }
+    else
+    {
+        SetMatrixFocus(matrix, &matrix->rows, -1, -1);
+    }
+}
+
+// Move a rolagem para acompanhar o cursor da barra sendo arrastada
+void DragMatrixScrollbar(Matrix *matrix, int mouseX, int mouseY)
+{
+    MatrixLayout *layout = &matrix->layout;
+    MatrixView *view = &matrix->view;
+
+    float thumbStart, thumbSize;
+
+    if (view->dragging == MTX_DRAG_HORIZONTAL)
+    {
+        float visible = view->width / view->zoom;
+
+        MatrixScrollbarThumb(view->width, visible, layout->contentWidth, view->scrollX, &thumbStart, &thumbSize);
+
+        float start = mouseX - view->dragOffset - MatrixViewLeft(matrix);
+        float track = view->width - thumbSize;
+
+        if (track > 0)
+            view->scrollX = start / track * (layout->contentWidth - visible);
+    }
+    else if (view->dragging == MTX_DRAG_VERTICAL)
+    {
+        float visible = view->height / view->zoom;
+
+        MatrixScrollbarThumb(view->height, visible, layout->contentHeight, view->scrollY, &thumbStart, &thumbSize);
+
+        float start = mouseY - view->dragOffset - MatrixViewTop(matrix);
+        float track = view->height - thumbSize;
+
+        if (track > 0)
+            view->scrollY = start / track * (layout->contentHeight - visible);
+    }
+
+    UpdateMatrixView(matrix);
+}
+
+// Inicia o arraste de uma barra de rolagem caso o clique tenha sido sobre ela
+// Um clique fora do cursor o centraliza sob o mouse
+bool PressMatrixScrollbar(Matrix *matrix, int mouseX, int mouseY)
+{
+    MatrixLayout *layout = &matrix->layout;
+    MatrixView *view = &matrix->view;
+
+    float left = MatrixViewLeft(matrix);
+    float top = MatrixViewTop(matrix);
+
+    float thumbStart, thumbSize;
+
+    float barX = left + view->width + MTX_SPACING;
+    float barY = top + view->height + MTX_SPACING;
+
+    if (view->horizontal && mouseX >= left && mouseX <= left + view->width && mouseY >= barY && mouseY <= barY + MTX_SCROLLBAR_SIZE)
+    {
+        MatrixScrollbarThumb(view->width, view->width / view->zoom, layout->contentWidth, view->scrollX, &thumbStart, &thumbSize);
+
+        float offset = mouseX - left - thumbStart;
+
+        view->dragging = MTX_DRAG_HORIZONTAL;
+        view->dragOffset = offset >= 0 && offset <= thumbSize ? offset : thumbSize / 2;
+    }
+    else if (view->vertical && mouseX >= barX && mouseX <= barX + MTX_SCROLLBAR_SIZE && mouseY >= top && mouseY <= top + view->height)
+    {
+        MatrixScrollbarThumb(view->height, view->height / view->zoom, layout->contentHeight, view->scrollY, &thumbStart, &thumbSize);
+
+        float offset = mouseY - top - thumbStart;
+
+        view->dragging = MTX_DRAG_VERTICAL;
+        view->dragOffset = offset >= 0 && offset <= thumbSize ? offset : thumbSize / 2;
+    }
+    else
+    {
+        return false;
+    }
+
+    DragMatrixScrollbar(matrix, mouseX, mouseY);
+
+    return true;
+}
+
 // Processa o mouse para a matriz
+// Apenas a célula anteriormente sob o mouse e a nova célula são atualizadas
 void ProccessMatrixMouse(Matrix *matrix, int mouseX, int mouseY, int mouseButton, int mouseState)
 {
-    for (int i = 0; i < MatrixRows(matrix); i++)
+    UpdateMatrixView(matrix);
+
+    if (mouseButton == 0 && mouseState == 1)
+        matrix->view.dragging = MTX_DRAG_NONE;
+
+    if (matrix->view.dragging != MTX_DRAG_NONE)
     {
-        for (int j = 0; j < MatrixColumns(matrix); j++)
-        {
-            ProccessNumberBoxMouse(&matrix->boxes[i][j], mouseX, mouseY, mouseButton, mouseState);
-        }
+        DragMatrixScrollbar(matrix, mouseX, mouseY);
+        return;
     }
 
-    ProccessNumberBoxMouse(&matrix->rows, mouseX, mouseY, mouseButton, mouseState);
-    ProccessNumberBoxMouse(&matrix->columns, mouseX, mouseY, mouseButton, mouseState);
+    if (mouseButton == 0 && mouseState == 0 && PressMatrixScrollbar(matrix, mouseX, mouseY))
+        return;
+
+    int cellI, cellJ;
+    bool found = FindMatrixCell(matrix, mouseX, mouseY, &cellI, &cellJ);
+
+    if (matrix->hoveredI != -1)
+        MatrixBox(matrix, matrix->hoveredI, matrix->hoveredJ)->hovering = false;
+
+    matrix->hoveredI = found ? cellI : -1;
+    matrix->hoveredJ = found ? cellJ : -1;
+
+    if (found)
+        MatrixBox(matrix, cellI, cellJ)->hovering = true;
+
+    matrix->rows.hovering = IsInsideNumberBox(&matrix->rows, mouseX, mouseY);
+    matrix->columns.hovering = IsInsideNumberBox(&matrix->columns, mouseX, mouseY);
+
+    // O clique move o foco para a caixa sob o mouse, ou o remove
+    if (mouseButton == 0 && mouseState == 0)
+    {
+        if (found)
+            FocusMatrixCell(matrix, cellI, cellJ);
+        else if (matrix->rows.hovering)
+            SetMatrixFocus(matrix, &matrix->rows, -1, -1);
+        else if (matrix->columns.hovering)
+            SetMatrixFocus(matrix, &matrix->columns, -1, -1);
+        else
+            SetMatrixFocus(matrix, NULL, -1, -1);
+    }
+}
+
+// Processa a roda do mouse sobre a janela da matriz: amplia ou reduz as células ao
+// redor do mouse, ou rola o conteúdo na vertical (Shift) ou na horizontal (Ctrl)
+void ProccessMatrixWheel(Matrix *matrix, int mouseX, int mouseY, int direction, int modifiers)
+{
+    UpdateMatrixView(matrix);
+
+    MatrixView *view = &matrix->view;
+
+    float left = MatrixViewLeft(matrix);
+    float top = MatrixViewTop(matrix);
+
+    if (mouseX < left || mouseX > left + view->width || mouseY < top || mouseY > top + view->height)
+        return;
+
+    if (modifiers & GLUT_ACTIVE_SHIFT)
+    {
+        view->scrollY -= direction * MTX_WHEEL_STEP / view->zoom;
+    }
+    else if (modifiers & GLUT_ACTIVE_CTRL)
+    {
+        view->scrollX -= direction * MTX_WHEEL_STEP / view->zoom;
+    }
+    else
+    {
+        float contentX = view->scrollX + (mouseX - left) / view->zoom;
+        float contentY = view->scrollY + (mouseY - top) / view->zoom;
+
+        float zoom = direction > 0 ? view->zoom * MTX_ZOOM_STEP : view->zoom / MTX_ZOOM_STEP;
+
+        zoom = fminf(fmaxf(zoom, MTX_MIN_ZOOM), MTX_MAX_ZOOM);
+
+        // Os passos acumulam erros de arredondamento, mas a escala original deve ser exata
+        if (fabsf(zoom - 1) < 0.01f)
+            zoom = 1;
+
+        view->zoom = zoom;
+
+        // O ponto do conteúdo sob o mouse permanece no mesmo lugar da tela
+        view->scrollX = contentX - (mouseX - left) / zoom;
+        view->scrollY = contentY - (mouseY - top) / zoom;
+    }
+
+    UpdateMatrixView(matrix);
 }
 
 // Processa a entrada do teclado para a matriz
+// A tecla vai direto para a caixa com o foco; Tab e as setas movem o foco entre as células
 void ProccessMatrixInput(Matrix *matrix, int key)
 {
-    for (int i = 0; i < MatrixRows(matrix); i++)
+    if (matrix->focused == NULL)
+        return;
+
+    // A célula com o foco pode ter deixado a matriz após uma mudança de dimensões
+    if (matrix->focusedI >= MatrixRows(matrix) || matrix->focusedJ >= MatrixColumns(matrix))
     {
-        for (int j = 0; j < MatrixColumns(matrix); j++)
+        SetMatrixFocus(matrix, NULL, -1, -1);
+        return;
+    }
+
+    bool cell = matrix->focusedI != -1;
+
+    switch (key)
+    {
+    case MTX_KEY_TAB:
+        FocusNextMatrixBox(matrix);
+        break;
+    case MTX_KEY_LEFT:
+        if (cell)
+            FocusMatrixCell(matrix, matrix->focusedI, matrix->focusedJ - 1);
+        break;
+    case MTX_KEY_RIGHT:
+        if (cell)
+            FocusMatrixCell(matrix, matrix->focusedI, matrix->focusedJ + 1);
+        break;
+    case MTX_KEY_UP:
+        if (cell)
+            FocusMatrixCell(matrix, matrix->focusedI - 1, matrix->focusedJ);
+        break;
+    case MTX_KEY_DOWN:
+        if (cell)
+            FocusMatrixCell(matrix, matrix->focusedI + 1, matrix->focusedJ);
+        break;
+    default:
+    {
+        double previous = matrix->focused->value;
+        double previousImaginary = matrix->focused->imaginary;
+
+        if (ProccessNumberBoxInput(matrix->focused, key))
         {
-            matrix->changed = ProccessNumberBoxInput(&matrix->boxes[i][j], key) || matrix->changed;
+            matrix->changed = true;
+
+            // As dimensões mudam todo o layout; um valor muda apenas a sua coluna
+            if (cell)
+            {
+                UpdateMatrixCellLayout(matrix, matrix->focusedI, matrix->focusedJ);
+                SetHeatmapValue(&matrix->heatmap, matrix->focusedI, matrix->focusedJ, matrix->focused->value);
+            }
+            else
+            {
+                matrix->layout.outdated = true;
+            }
+
+            if (matrix->focused->value != previous || matrix->focused->imaginary != previousImaginary)
+            {
+                int position = cell ? matrix->focusedI * MatrixColumns(matrix) + matrix->focusedJ : 0;
+                MarkMatrixEdited(matrix, position, cell ? position : INT_MAX);
+            }
+
+            // As dimensões digitadas podem exigir mais células
+            ReserveMatrix(matrix, MatrixRows(matrix), MatrixColumns(matrix));
         }
+        break;
+    }
     }
+}
+
+// Registra a matriz no histórico a partir do registro anterior (NULL caso não exista),
+// copiando apenas os pedaços com valores alterados
+// previous e snapshot apontam para dois registros seguidos: as partes reais e as imaginárias
+// Retorna verdadeiro caso a matriz seja diferente do registro anterior
+bool RecordMatrix(Matrix *matrix, History *history, const HistorySnapshot *previous, HistorySnapshot *snapshot)
+{
+    int rows = MatrixRows(matrix);
+    int columns = MatrixColumns(matrix);
+    int count = rows * columns;
+
+    // Com outras dimensões as posições mudam, então todos os pedaços são conferidos
+    bool resized = previous == NULL || previous->rows != rows || previous->columns != columns;
+    bool changed = resized;
+
+    int first = resized ? 0 : matrix->editFirst;
+    int last = resized || matrix->editLast >= count ? count - 1 : matrix->editLast;
+
+    double values[HST_CHUNK_SIZE];
+
+    for (int part = 0; part < 2; part++)
+    {
+        BeginSnapshot(history, previous != NULL ? &previous[part] : NULL, rows, columns, &snapshot[part]);
+
+        for (int k = first / HST_CHUNK_SIZE; first <= last && k <= last / HST_CHUNK_SIZE; k++)
+        {
+            int start = k * HST_CHUNK_SIZE;
+            int length = count - start < HST_CHUNK_SIZE ? count - start : HST_CHUNK_SIZE;
+
+            for (int t = 0; t < length; t++)
+            {
+                NumberBox *box = MatrixBox(matrix, (start + t) / columns, (start + t) % columns);
+
+                values[t] = part == 0 ? box->value : box->imaginary;
+            }
+
+            if (StoreSnapshotChunk(history, &snapshot[part], k, values, length))
+                changed = true;
+        }
+    }
+
+    matrix->editFirst = 0;
+    matrix->editLast = -1;
+
+    return changed;
+}
+
+// Leva a matriz do registro current até o registro target, alterando apenas os pedaços diferentes
+// Como em RecordMatrix, cada registro é seguido pelo das partes imaginárias
+void RestoreMatrix(Matrix *matrix, const HistorySnapshot *current, const HistorySnapshot *target)
+{
+    bool sameColumns = current->columns == target->columns;
+
+    SetMatrixRows(matrix, target->rows);
+    SetMatrixColumns(matrix, target->columns);
+
+    int columns = target->columns;
+
+    for (int part = 0; part < 2; part++)
+    {
+        for (int k = 0; k < target[part].chunkCount; k++)
+        {
+            // Um pedaço compartilhado já está na matriz, desde que as posições sejam as mesmas
+            if (sameColumns && k < current[part].chunkCount && current[part].chunks[k] == target[part].chunks[k])
+                continue;
+
+            HistoryChunk *chunk = target[part].chunks[k];
+            int start = k * HST_CHUNK_SIZE;
+
+            for (int t = 0; t < chunk->count; t++)
+            {
+                if (part == 0)
+                    SetMatrixValue(matrix, (start + t) / columns, (start + t) % columns, chunk->values[t]);
+                else
+                    SetMatrixImaginary(matrix, (start + t) / columns, (start + t) % columns, chunk->values[t]);
+            }
+        }
+    }
+
+    // A matriz volta a ser igual a um registro existente
+    matrix->editFirst = 0;
+    matrix->editLast = -1;
+}
+
+// Grava no arquivo de sessão os valores da matriz e o que já foi calculado sobre eles
+void SaveMatrixSnapshot(Matrix *matrix, SnapshotWriter *writer)
+{
+    MatrixSnapshot info;
+    memset(&info, 0, sizeof(info));
+
+    info.rows = MatrixRows(matrix);
+    info.columns = MatrixColumns(matrix);
+
+    info.structureFlags = matrix->structure.flags;
+    info.structureLower = matrix->structure.lower;
+    info.structureUpper = matrix->structure.upper;
+
+    info.exact = matrix->exact;
+    info.hasExactDeterminant = matrix->hasExactDeterminant;
+    info.complex = matrix->complex;
+
+    info.determinant = matrix->determinant;
+    info.imaginaryDeterminant = matrix->imaginaryDeterminant;
+    memcpy(info.exactDeterminant, matrix->exactDeterminant, MTX_DETERMINANT_DIGITS);
+
+    size_t size = (size_t)info.rows * info.columns * sizeof(double);
+
+    double *elements = (double *)malloc(size + sizeof(double));
+    GetMatrixElements(matrix, elements);
+
+    WriteSnapshotSection(writer, MTX_SNAPSHOT_INFO, matrix->letter, &info, sizeof(info));
+    WriteSnapshotSection(writer, MTX_SNAPSHOT_VALUES, matrix->letter, elements, size);
+
+    if (matrix->complex)
+    {
+        GetMatrixImaginary(matrix, elements);
+        WriteSnapshotSection(writer, MTX_SNAPSHOT_IMAGINARY, matrix->letter, elements, size);
+    }
+
+    free(elements);
+
+    // As frações de um resultado exato só são gravadas quando exibidas
+    size_t count = (size_t)info.rows * info.columns;
+    Fraction *fractions = (Fraction *)malloc((count + 1) * sizeof(Fraction));
+
+    if (GetMatrixFractions(matrix, fractions))
+        WriteSnapshotSection(writer, MTX_SNAPSHOT_FRACTIONS, matrix->letter, fractions, count * sizeof(Fraction));
+
+    free(fractions);
+}
+
+// Restaura a matriz a partir do arquivo de sessão, sem recalcular a estrutura e o determinante
+// Retorna falso caso o arquivo não possua a matriz (que não é alterada)
+bool LoadMatrixSnapshot(Matrix *matrix, const Snapshot *snapshot)
+{
+    const MatrixSnapshot *info = (const MatrixSnapshot *)FindSnapshotSection(snapshot, MTX_SNAPSHOT_INFO, matrix->letter, sizeof(MatrixSnapshot));
+
+    if (info == NULL ||
+        info->rows < 0 || info->rows > MTX_MAX_SIZE ||
+        info->columns < 0 || info->columns > MTX_MAX_SIZE)
+    {
+        return false;
+    }
+
+    size_t size = (size_t)info->rows * info->columns * sizeof(double);
+
+    const double *elements = (const double *)FindSnapshotSection(snapshot, MTX_SNAPSHOT_VALUES, matrix->letter, size);
+
+    const double *imaginary = NULL;
+
+    if (info->complex)
+        imaginary = (const double *)FindSnapshotSection(snapshot, MTX_SNAPSHOT_IMAGINARY, matrix->letter, size);
+
+    if ((elements == NULL || (info->complex && imaginary == NULL)) && size > 0)
+        return false;
+
+    // Um cálculo ainda em andamento não pode chegar depois e substituir os valores do arquivo
+    WaitWorker(&matrix->worker);
+    ReceiveMatrixProperties(matrix);
+
+    // Reservar as duas dimensões de uma vez evita copiar as células duas vezes
+    ReserveMatrix(matrix, info->rows, info->columns);
+    SetMatrixElements(matrix, elements, info->rows, info->columns, imaginary);
+    SetMatrixFractions(matrix, (const Fraction *)FindSnapshotSection(snapshot, MTX_SNAPSHOT_FRACTIONS, matrix->letter, (size_t)info->rows * info->columns * sizeof(Fraction)));
+
+    matrix->structure.flags = info->structureFlags;
+    matrix->structure.lower = info->structureLower;
+    matrix->structure.upper = info->structureUpper;
+
+    matrix->exact = info->exact != 0;
+    matrix->hasExactDeterminant = info->hasExactDeterminant != 0;
+    matrix->complex = info->complex != 0;
+
+    matrix->determinant = info->determinant;
+    matrix->imaginaryDeterminant = info->imaginaryDeterminant;
+    memcpy(matrix->exactDeterminant, info->exactDeterminant, MTX_DETERMINANT_DIGITS);
+    matrix->exactDeterminant[MTX_DETERMINANT_DIGITS - 1] = '\0';
+
+    matrix->changed = false;
 
-    matrix->changed = ProccessNumberBoxInput(&matrix->rows, key) || matrix->changed;
-    matrix->changed = ProccessNumberBoxInput(&matrix->columns, key) || matrix->changed;
+    return true;
 }
 
 #endif
@@ -0,0 +1,381 @@
+/*********************************************************************
+// Modular.h
+// Cálculo do determinante exato de matrizes inteiras de qualquer ordem.
+// O determinante é calculado módulo vários primos de 62 bits com a
+// aritmética de Montgomery, cada primo em sua própria thread, e depois
+// reconstruído pelo Teorema Chinês do Resto. A quantidade de primos é
+// definida pela cota de Hadamard do determinante.
+// *********************************************************************/
+
+#ifndef MODULAR_H
+#define MODULAR_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BigInt.h"
+#include "Parallel.h"
+
+#define MOD_PRIME_BITS 62
+#define MOD_MAX_PRIMES 4096
+
+// Maior valor absoluto que um double representa sem perda como inteiro
+#define MOD_MAX_EXACT 9007199254740992.0
+
+typedef struct
+{
+    uint64_t modulus;
+    uint64_t inverse; // -modulus^-1 mod 2^64
+    uint64_t r2;      // 2^128 mod modulus
+} Montgomery;
+
+// Inicializa os parâmetros de Montgomery para um módulo ímpar menor que 2^62
+void InitializeMontgomery(Montgomery *montgomery, uint64_t modulus)
+{
+    uint64_t inverse = modulus;
+
+    // Iteração de Newton: cada passo dobra os bits corretos do inverso
+    for (int i = 0; i < 5; i++)
+        inverse *= 2 - modulus * inverse;
+
+    montgomery->modulus = modulus;
+    montgomery->inverse = -inverse;
+
+    unsigned __int128 r = ((unsigned __int128)1 << 64) % modulus;
+    montgomery->r2 = (uint64_t)(r * r % modulus);
+}
+
+// Redução de Montgomery: retorna value * 2^-64 mod modulus
+uint64_t ReduceMontgomery(const Montgomery *montgomery, unsigned __int128 value)
+{
+    uint64_t m = (uint64_t)value * montgomery->inverse;
+    uint64_t result = (uint64_t)((value + (unsigned __int128)m * montgomery->modulus) >> 64);
+
+    return result >= montgomery->modulus ? result - montgomery->modulus : result;
+}
+
+// Multiplica dois valores na forma de Montgomery
+uint64_t MultiplyMontgomery(const Montgomery *montgomery, uint64_t a, uint64_t b)
+{
+    return ReduceMontgomery(montgomery, (unsigned __int128)a * b);
+}
+
+// Converte um resíduo para a forma de Montgomery
+uint64_t ToMontgomery(const Montgomery *montgomery, uint64_t value)
+{
+    return MultiplyMontgomery(montgomery, value % montgomery->modulus, montgomery->r2);
+}
+
+// Converte um valor da forma de Montgomery para um resíduo comum
+uint64_t FromMontgomery(const Montgomery *montgomery, uint64_t value)
+{
+    return ReduceMontgomery(montgomery, value);
+}
+
+// Eleva uma base na forma de Montgomery a um expoente
+uint64_t PowerMontgomery(const Montgomery *montgomery, uint64_t base, uint64_t exponent)
+{
+    uint64_t result = ToMontgomery(montgomery, 1);
+
+    while (exponent > 0)
+    {
+        if (exponent & 1)
+            result = MultiplyMontgomery(montgomery, result, base);
+
+        base = MultiplyMontgomery(montgomery, base, base);
+        exponent >>= 1;
+    }
+
+    return result;
+}
+
+// Teste de primalidade de Miller-Rabin, determinístico para 64 bits
+bool IsPrime(uint64_t n)
+{
+    static const uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+
+    if (n < 2)
+        return false;
+
+    for (int i = 0; i < 12; i++)
+    {
+        if (n % bases[i] == 0)
+            return n == bases[i];
+    }
+
+    uint64_t d = n - 1;
+    int s = 0;
+
+    while ((d & 1) == 0)
+    {
+        d >>= 1;
+        s++;
+    }
+
+    Montgomery montgomery;
+    InitializeMontgomery(&montgomery, n);
+
+    uint64_t one = ToMontgomery(&montgomery, 1);
+    uint64_t minusOne = ToMontgomery(&montgomery, n - 1);
+
+    for (int i = 0; i < 12; i++)
+    {
+        uint64_t x = PowerMontgomery(&montgomery, ToMontgomery(&montgomery, bases[i]), d);
+
+        if (x == one || x == minusOne)
+            continue;
+
+        bool composite = true;
+
+        for (int r = 1; r < s && composite; r++)
+        {
+            x = MultiplyMontgomery(&montgomery, x, x);
+            composite = x != minusOne;
+        }
+
+        if (composite)
+            return false;
+    }
+
+    return true;
+}
+
+// Retorna o k-ésimo maior primo abaixo de 2^62 (gerados sob demanda)
+// A tabela é compartilhada pelas threads que calculam determinantes ao mesmo tempo
+uint64_t ModularPrime(int k)
+{
+    static uint64_t primes[MOD_MAX_PRIMES];
+    static int count = 0;
+    static std::mutex mutex;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    while (count <= k)
+    {
+        uint64_t candidate = count == 0 ? ((uint64_t)1 << MOD_PRIME_BITS) - 1 : primes[count - 1] - 2;
+
+        while (!IsPrime(candidate))
+            candidate -= 2;
+
+        primes[count++] = candidate;
+    }
+
+    return primes[k];
+}
+
+// Calcula o determinante de um array de inteiros módulo um primo
+uint64_t CalculateDeterminantModulo(const double *elements, int size, uint64_t prime)
+{
+    Montgomery montgomery;
+    InitializeMontgomery(&montgomery, prime);
+
+    uint64_t *residues = (uint64_t *)malloc((size_t)size * size * sizeof(uint64_t));
+
+    for (int i = 0; i < size * size; i++)
+    {
+        int64_t value = (int64_t)elements[i];
+        uint64_t residue = value >= 0 ? (uint64_t)value % prime : prime - (uint64_t)(-value) % prime;
+
+        residues[i] = ToMontgomery(&montgomery, residue);
+    }
+
+    uint64_t determinant = ToMontgomery(&montgomery, 1);
+
+    for (int k = 0; k < size && determinant != 0; k++)
+    {
+        int pivot = k;
+
+        while (pivot < size && residues[pivot * size + k] == 0)
+            pivot++;
+
+        if (pivot == size)
+        {
+            determinant = 0;
+            break;
+        }
+
+        if (pivot != k)
+        {
+            for (int j = k; j < size; j++)
+            {
+                uint64_t temp = residues[k * size + j];
+
+                residues[k * size + j] = residues[pivot * size + j];
+                residues[pivot * size + j] = temp;
+            }
+
+            determinant = prime - determinant;
+        }
+
+        uint64_t diagonal = residues[k * size + k];
+        uint64_t inverse = PowerMontgomery(&montgomery, diagonal, prime - 2);
+
+        determinant = MultiplyMontgomery(&montgomery, determinant, diagonal);
+
+        for (int i = k + 1; i < size; i++)
+        {
+            uint64_t coefficient = MultiplyMontgomery(&montgomery, residues[i * size + k], inverse);
+
+            if (coefficient == 0)
+                continue;
+
+            for (int j = k + 1; j < size; j++)
+            {
+                uint64_t product = MultiplyMontgomery(&montgomery, coefficient, residues[k * size + j]);
+                uint64_t value = residues[i * size + j];
+
+                residues[i * size + j] = value >= product ? value - product : value + prime - product;
+            }
+        }
+    }
+
+    free(residues);
+
+    return FromMontgomery(&montgomery, determinant);
+}
+
+// Calcula log2 da cota de Hadamard: |det| <= produto das normas das linhas
+double HadamardBoundBits(const double *elements, int size)
+{
+    double bits = 0;
+
+    for (int i = 0; i < size; i++)
+    {
+        double norm = 0;
+
+        for (int j = 0; j < size; j++)
+            norm += elements[i * size + j] * elements[i * size + j];
+
+        if (norm == 0)
+            return -1;
+
+        bits += 0.5 * log2(norm);
+    }
+
+    return bits;
+}
+
+// Calcula o determinante exato de um array de inteiros de qualquer ordem
+// e o imprime em base decimal no texto de destino
+// Retorna falso caso algum elemento não seja um inteiro exato ou o limite de
+// Hadamard permita um determinante maior que o texto (verificado antes de qualquer eliminação)
+bool CalculateExactDeterminant(const double *elements, int size, char *destination, int capacity)
+{
+    for (int i = 0; i < size * size; i++)
+    {
+        if (elements[i] != floor(elements[i]) || fabs(elements[i]) >= MOD_MAX_EXACT)
+            return false;
+    }
+
+    double bits = HadamardBoundBits(elements, size);
+
+    if (size == 0 || bits < 0)
+    {
+        if (capacity < 2)
+            return false;
+
+        strcpy(destination, size == 0 ? "1" : "0");
+        return true;
+    }
+
+    // Os dígitos do maior determinante possível, o sinal e o fim do texto precisam caber
+    if (floor(bits * log10(2.0)) + 3 > capacity)
+        return false;
+
+    // Cada primo contribui com pelo menos 61 bits e o sinal exige um bit extra
+    int primeCount = (int)ceil((bits + 2) / (MOD_PRIME_BITS - 1));
+
+    if (primeCount > MOD_MAX_PRIMES)
+        return false;
+
+    std::vector<uint64_t> primes(primeCount);
+    std::vector<uint64_t> residues(primeCount);
+
+    for (int k = 0; k < primeCount; k++)
+        primes[k] = ModularPrime(k);
+
+    // Cada primo é processado por uma única thread, limitadas a ParallelThreadCount
+    int threadCount = ParallelThreadCount();
+
+    if (threadCount > primeCount)
+        threadCount = primeCount;
+
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.push_back(std::thread([&, t]()
+        {
+            for (int k = t; k < primeCount; k += threadCount)
+                residues[k] = CalculateDeterminantModulo(elements, size, primes[k]);
+        }));
+    }
+
+    for (int t = 0; t < threadCount; t++)
+        threads[t].join();
+
+    // Algoritmo de Garner: obtém os dígitos do determinante na base mista dos primos
+    std::vector<uint64_t> digits(primeCount);
+
+    for (int k = 0; k < primeCount; k++)
+    {
+        Montgomery montgomery;
+        InitializeMontgomery(&montgomery, primes[k]);
+
+        uint64_t value = ToMontgomery(&montgomery, residues[k]);
+
+        for (int l = 0; l < k; l++)
+        {
+            uint64_t digit = ToMontgomery(&montgomery, digits[l]);
+            uint64_t difference = value >= digit ? value - digit : value + primes[k] - digit;
+
+            uint64_t inverse = PowerMontgomery(&montgomery, ToMontgomery(&montgomery, primes[l]), primes[k] - 2);
+
+            value = MultiplyMontgomery(&montgomery, difference, inverse);
+        }
+
+        digits[k] = FromMontgomery(&montgomery, value);
+    }
+
+    BigInt determinant, modulus;
+
+    InitializeBigInt(&determinant);
+    InitializeBigInt(&modulus);
+
+    SetBigIntUnsigned(&modulus, 1);
+
+    for (int k = primeCount - 1; k >= 0; k--)
+        MultiplyAddBigInt(&determinant, primes[k], digits[k]);
+
+    for (int k = 0; k < primeCount; k++)
+        MultiplyAddBigInt(&modulus, primes[k], 0);
+
+    // Valores acima de metade do módulo representam determinantes negativos
+    BigInt half;
+
+    InitializeBigInt(&half);
+    CopyBigInt(&half, &modulus);
+    DivideBigIntSmall(&half, 2);
+
+    if (CompareBigIntMagnitude(&determinant, &half) > 0)
+    {
+        SubtractBigIntMagnitude(&modulus, &determinant);
+        CopyBigInt(&determinant, &modulus);
+
+        determinant.sign = -1;
+    }
+
+    bool printed = PrintBigInt(&determinant, destination, capacity);
+
+    FreeBigInt(&determinant);
+    FreeBigInt(&modulus);
+    FreeBigInt(&half);
+
+    return printed;
+}
+
+#endif
@@ -3,16 +3,27 @@
 // Implementação de uma caixa de entrada na qual o usuário pode digitar
 // seus próprios números com o teclado. A caixa muda a cor de suas bordas
 // quando o mouse está sobre ela ou quando está recebendo a entrada do
-// usuário.
+// usuário. O texto formatado e sua largura ficam guardados na caixa e
+// só são refeitos quando o valor ou o formato mudam. Caixas complexas
+// também guardam uma parte imaginária, exibida como a+bi e digitada
+// depois da tecla i ou do sinal que segue a parte real (3+4i ou 3-4i).
+// Uma caixa pode ainda exibir uma fração exata no lugar do valor formatado.
 // *********************************************************************/
 
 #ifndef NUMBERBOX_H
 #define NUMBERBOX_H
 
+#include <stdint.h>
+
 #include "Assistant.h"
+#include "Format.h"
 
 #define NB_PADDING 8
 
+// Tamanho do texto guardado na caixa; valores que não cabem nele são exibidos em notação científica
+#define NB_TEXT_SIZE 32
+#define NB_SCIENTIFIC_DIGITS 6
+
 typedef struct
 {
     float x, y;
@@ -20,9 +31,27 @@ typedef struct
     double value;
     double min, max;
 
+    // Parte imaginária, aceita apenas por caixas complexas
+    double imaginary;
+    bool complex;
+
+    // Verdadeiro enquanto os dígitos digitados vão para a parte imaginária
+    bool imaginaryInput;
+
+    // Fração exata exibida no lugar do valor, ignorada enquanto o denominador for zero
+    int64_t numerator, denominator;
+
     bool locked;
     char format[10];
 
+    // Casas decimais do formato "%.Nf" ou -1 caso o formato exija o sprintf
+    int decimals;
+
+    // Texto do valor e sua largura, válidos enquanto outdated for falso
+    char text[NB_TEXT_SIZE];
+    float textWidth;
+    bool outdated;
+
     bool hovering, focused;
 } NumberBox;
 
@@ -34,6 +63,13 @@ void InitializeNumberBox(NumberBox *box, double value, double min, double max, b
 
     box->value = value;
 
+    box->imaginary = 0;
+    box->complex = false;
+    box->imaginaryInput = false;
+
+    box->numerator = 0;
+    box->denominator = 0;
+
     box->min = min;
     box->max = max;
 
@@ -43,21 +79,131 @@ void InitializeNumberBox(NumberBox *box, double value, double min, double max, b
     box->focused = false;
 
     strcpy(box->format, format);
+    box->decimals = ParseFixedFormat(format);
+
+    box->outdated = true;
+}
+
+// Formata novamente o texto da caixa caso o valor ou o formato tenham mudado
+void RefreshNumberBox(NumberBox *box)
+{
+    if (!box->outdated)
+        return;
+
+    int length;
+
+    if (box->denominator == 1)
+        length = snprintf(box->text, NB_TEXT_SIZE, "%lld", (long long)box->numerator);
+    else if (box->denominator != 0)
+        length = snprintf(box->text, NB_TEXT_SIZE, "%lld/%lld", (long long)box->numerator, (long long)box->denominator);
+    else if (box->decimals >= 0)
+        length = FormatFixed(box->value, box->decimals, box->text, NB_TEXT_SIZE);
+    else
+        length = snprintf(box->text, NB_TEXT_SIZE, box->format, box->value);
+
+    bool imaginary = box->imaginary != 0 || box->imaginaryInput;
+
+    // A parte imaginária segue a real com o seu sinal e o i
+    if (imaginary && length < NB_TEXT_SIZE)
+    {
+        char part[NB_TEXT_SIZE];
+        int partLength;
+
+        if (box->decimals >= 0)
+            partLength = FormatFixed(fabs(box->imaginary), box->decimals, part, NB_TEXT_SIZE);
+        else
+            partLength = snprintf(part, NB_TEXT_SIZE, box->format, fabs(box->imaginary));
+
+        if (length + partLength + 2 < NB_TEXT_SIZE)
+        {
+            box->text[length++] = signbit(box->imaginary) ? '-' : '+';
+
+            memcpy(box->text + length, part, partLength);
+            length += partLength;
+
+            box->text[length++] = 'i';
+            box->text[length] = '\0';
+        }
+        else
+        {
+            length = NB_TEXT_SIZE;
+        }
+    }
+
+    if (length >= NB_TEXT_SIZE && imaginary)
+        snprintf(box->text, NB_TEXT_SIZE, "%.*e%+.*ei", NB_SCIENTIFIC_DIGITS - 2, box->value, NB_SCIENTIFIC_DIGITS - 2, box->imaginary);
+    else if (length >= NB_TEXT_SIZE)
+        snprintf(box->text, NB_TEXT_SIZE, "%.*e", NB_SCIENTIFIC_DIGITS, box->value);
+
+    box->textWidth = TextLength(box->text);
+
+    box->outdated = false;
+}
+
+// Retorna o texto formatado do valor da caixa de número
+const char *NumberBoxText(NumberBox *box)
+{
+    RefreshNumberBox(box);
+
+    return box->text;
+}
+
+// Define o valor da caixa de número, que deixa de exibir uma fração
+void SetNumberBoxValue(NumberBox *box, double value)
+{
+    if (box->value != value || box->denominator != 0)
+    {
+        box->value = value;
+        box->denominator = 0;
+        box->outdated = true;
+    }
+}
+
+// Define a fração exibida pela caixa de número (denominador positivo, ou zero para voltar ao valor)
+void SetNumberBoxFraction(NumberBox *box, int64_t numerator, int64_t denominator)
+{
+    if (box->numerator != numerator || box->denominator != denominator)
+    {
+        box->numerator = numerator;
+        box->denominator = denominator;
+        box->outdated = true;
+    }
+}
+
+// Define a parte imaginária da caixa de número
+void SetNumberBoxImaginary(NumberBox *box, double imaginary)
+{
+    if (box->imaginary != imaginary)
+    {
+        box->imaginary = imaginary;
+        box->outdated = true;
+    }
+}
+
+// Define o formato (no padrão do printf) usado para exibir o valor
+void SetNumberBoxFormat(NumberBox *box, const char *format)
+{
+    if (strcmp(box->format, format) != 0)
+    {
+        strcpy(box->format, format);
+        box->decimals = ParseFixedFormat(format);
+
+        box->outdated = true;
+    }
 }
 
 // Imprime o valor da caixa de número no texto de destino
 void PrintNumberBox(NumberBox *box, char *destination)
 {
-    sprintf(destination, box->format, box->value);
+    strcpy(destination, NumberBoxText(box));
 }
 
 // Calcula a largura da caixa de número (largura do texto + bordas)
 float NumberBoxWidth(NumberBox *box)
 {
-    char text[TEXT_BUFFER_SIZE];
-    PrintNumberBox(box, text);
+    RefreshNumberBox(box);
 
-    return 2 * NB_PADDING + TextLength(text);
+    return 2 * NB_PADDING + box->textWidth;
 }
 
 // Calcula a altura da caixa de número (altura do texto + bordas)
@@ -81,17 +227,16 @@ bool IsInsideNumberBox(NumberBox *box, int x, int y)
 // Desenha a caixa de número
 void DrawNumberBox(NumberBox *box)
 {
-    char text[TEXT_BUFFER_SIZE];
-    PrintNumberBox(box, text);
+    RefreshNumberBox(box);
 
     float textHeight = FONT_SIZE;
-    float textWidth = TextLength(text);
+    float textWidth = box->textWidth;
 
     float x = box->x + NB_PADDING;
     float y = box->y - NB_PADDING;
 
     Color8(0, 0, 0);
-    CV::text(x, y, text);
+    CV::text(x, y, box->text);
 
     x += textWidth;
 
@@ -132,50 +277,88 @@ void ProccessNumberBoxMouse(NumberBox *box, int mouseX, int mouseY, int mouseBut
     }
 }
 
+// Aplica uma tecla (dígito, sinal ou apagar) a um número sendo digitado, limitado a [min, max]
+double EditNumber(double value, int key, double min, double max)
+{
+    switch (key)
+    {
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+    case '0':
+    {
+        int digit = key - '0';
+
+        value *= 10;
+
+        // O zero negativo deixado por um - digitado antes dos dígitos mantém o sinal
+        if (!signbit(value))
+            value += digit;
+        else
+            value -= digit;
+
+        break;
+    }
+    case '-':
+        if (min < 0)
+            value *= -1;
+        break;
+    case 8:
+        value = (int)(value / 10);
+        break;
+    }
+
+    if (value > max)
+        value = max;
+
+    if (value < min)
+        value = min;
+
+    return value;
+}
+
 // Processa a entrada do teclado para a caixa de número
+// Nas caixas complexas, a tecla i alterna a parte que recebe os dígitos e
+// apagar uma parte imaginária já nula volta para a parte real. Na parte real,
+// + (ou - depois de algum dígito) começa a parte imaginária com esse sinal
 // Retorna verdadeiro caso houver alterações
 bool ProccessNumberBoxInput(NumberBox *box, int key)
 {
     if (box->focused)
     {
-        switch (key)
-        {
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-        case '0':
+        if (box->complex && (key == 'i' || (key == 8 && box->imaginaryInput && box->imaginary == 0)))
         {
-            int digit = key - '0';
+            box->imaginaryInput = !box->imaginaryInput;
+            box->outdated = true;
 
-            box->value *= 10;
+            return true;
+        }
 
-            if (box->value >= 0)
-                box->value += digit;
-            else
-                box->value -= digit;
+        if (box->complex && !box->imaginaryInput && (key == '+' || (key == '-' && box->value != 0)))
+        {
+            box->imaginaryInput = true;
+            box->imaginary = key == '-' ? -0.0 : 0.0;
+            box->outdated = true;
 
-            break;
-        }
-        case '-':
-            if (box->min < 0)
-                box->value *= -1;
-            break;
-        case 8:
-            box->value = (int)(box->value / 10);
-            break;
+            return true;
         }
 
-        if (box->value > box->max)
-            box->value = box->max;
+        double *part = box->imaginaryInput ? &box->imaginary : &box->value;
+        double previous = *part;
+
+        *part = EditNumber(*part, key, box->min, box->max);
 
-        if (box->value < box->min)
-            box->value = box->min;
+        if (*part != previous)
+        {
+            box->denominator = 0;
+            box->outdated = true;
+        }
 
         return true;
     }
@@ -0,0 +1,748 @@
+/*********************************************************************
+// Operations.h
+// Operações da expressão X op Y = Z sobre uma cópia das matrizes de
+// entrada. Cada cálculo é descrito por um Job, que guarda as entradas,
+// as opções escolhidas na interface e o resultado, e pode ser executado
+// em segundo plano enquanto as matrizes originais continuam sendo editadas.
+// Quando alguma entrada tem parte imaginária, o cálculo é complexo e segue
+// pelas rotinas de Complex.h, que cobrem parte das operações. No modo
+// exato, o Gauss Jordan de matrizes inteiras é feito em frações por Rational.h.
+// *********************************************************************/
+
+#ifndef OPERATIONS_H
+#define OPERATIONS_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Complex.h"
+#include "Dense.h"
+#include "Krylov.h"
+#include "Quantized.h"
+#include "Rational.h"
+#include "Sparse.h"
+#include "Structure.h"
+#include "Task.h"
+#include "Trace.h"
+
+#define OPERATION_NUM 8
+
+#define OPERATION_MULTIPLY 0
+#define OPERATION_ADD 1
+#define OPERATION_SUBTRACT 2
+#define OPERATION_GAUSS_JORDAN 3
+#define OPERATION_TRANSPOSE 4
+#define OPERATION_POWER 5
+#define OPERATION_EXPONENTIAL 6
+#define OPERATION_SOLVE 7
+
+#define PRECISION_NUM 3
+
+#define PRECISION_DOUBLE 0
+#define PRECISION_INT16 1
+#define PRECISION_INT8 2
+
+#define ZERO_THRESHOLD 0.000001
+
+#define KRYLOV_TOLERANCE 1e-12
+#define KRYLOV_MAX_ITERATIONS 1000
+#define KRYLOV_RESTART 30
+
+// Vetores aleatórios da verificação de Freivalds (um produto errado passa com chance de até 2^-8)
+#define FREIVALDS_TRIALS 8
+
+// Múltiplo de (size + columns) * DBL_EPSILON aceito como erro relativo da verificação
+#define FREIVALDS_TOLERANCE 4
+
+typedef struct
+{
+    // Opções da interface no momento do envio
+    int operation;
+    int precision;
+    bool iterative;
+    bool verify;
+    bool exact;
+    unsigned int exponent;
+
+    // Cópia das matrizes de entrada
+    int rowsX, columnsX;
+    int rowsY, columnsY;
+
+    double *x, *y;
+    Structure structureX, structureY;
+
+    // Com detectStructure, as estruturas são detectadas no início do cálculo, já em segundo plano
+    bool detectStructure;
+
+    // Resultado
+    bool success;
+    char error[100];
+
+    int rowsZ, columnsZ;
+    double *z;
+
+    double precisionError;
+
+    // Verificação de Freivalds do produto em double (quando verify é verdadeiro)
+    bool verified;
+    double verificationError;
+
+    KrylovHistory solveHistory;
+    char solveMethod[32];
+
+    // Registro das operações de linha do Gauss Jordan, feito apenas quando traced é verdadeiro
+    bool traced;
+    Trace *trace;
+
+    // Partes imaginárias das entradas e do resultado, alocadas apenas nos cálculos complexos
+    bool complex;
+    double *xi, *yi, *zi;
+
+    // Frações do resultado, alocadas apenas no Gauss Jordan exato de uma matriz inteira
+    Fraction *fractions;
+
+    // Memória compartilhada em que x, y e z estão no modo cliente (ClientBuffers, em Server.h),
+    // NULL quando as matrizes foram alocadas aqui
+    void *shared;
+} Job;
+
+// Aloca um cálculo com espaço para as entradas de tais dimensões
+Job *CreateJob(int operation, int rowsX, int columnsX, int rowsY, int columnsY)
+{
+    Job *job = (Job *)malloc(sizeof(Job));
+
+    job->operation = operation;
+    job->precision = PRECISION_DOUBLE;
+    job->iterative = false;
+    job->verify = false;
+    job->exact = false;
+    job->exponent = 1;
+
+    job->rowsX = rowsX;
+    job->columnsX = columnsX;
+    job->rowsY = rowsY;
+    job->columnsY = columnsY;
+
+    job->x = (double *)malloc(((size_t)rowsX * columnsX + 1) * sizeof(double));
+    job->y = (double *)malloc(((size_t)rowsY * columnsY + 1) * sizeof(double));
+
+    job->detectStructure = false;
+
+    job->success = false;
+    job->error[0] = '\0';
+
+    job->rowsZ = 0;
+    job->columnsZ = 0;
+    job->z = NULL;
+
+    job->precisionError = 0;
+
+    job->verified = false;
+    job->verificationError = 0;
+
+    job->solveHistory.iterations = 0;
+    job->solveHistory.converged = false;
+    job->solveMethod[0] = '\0';
+
+    job->traced = false;
+    job->trace = NULL;
+
+    job->complex = false;
+    job->xi = NULL;
+    job->yi = NULL;
+    job->zi = NULL;
+
+    job->fractions = NULL;
+
+    job->shared = NULL;
+
+    return job;
+}
+
+// Libera a memória ocupada pelo cálculo
+void FreeJob(void *work)
+{
+    Job *job = (Job *)work;
+
+    free(job->x);
+    free(job->y);
+    free(job->z);
+    free(job->xi);
+    free(job->yi);
+    free(job->zi);
+    free(job->fractions);
+    FreeTrace(job->trace);
+    free(job);
+}
+
+// Define as dimensões do resultado e aloca seu espaço
+double *AllocateJobResult(Job *job, int rows, int columns)
+{
+    job->rowsZ = rows;
+    job->columnsZ = columns;
+    job->z = (double *)malloc(((size_t)rows * columns + 1) * sizeof(double));
+
+    return job->z;
+}
+
+// Torna o cálculo complexo, alocando as partes imaginárias das entradas
+void SetJobComplex(Job *job)
+{
+    job->complex = true;
+
+    job->xi = (double *)malloc(((size_t)job->rowsX * job->columnsX + 1) * sizeof(double));
+    job->yi = (double *)malloc(((size_t)job->rowsY * job->columnsY + 1) * sizeof(double));
+}
+
+// Aloca a parte imaginária do resultado, com as dimensões de AllocateJobResult
+double *AllocateJobImaginary(Job *job)
+{
+    job->zi = (double *)malloc(((size_t)job->rowsZ * job->columnsZ + 1) * sizeof(double));
+
+    return job->zi;
+}
+
+// Marca o cálculo como falho com tal mensagem
+void FailJob(Job *job, const char *message)
+{
+    job->success = false;
+    strcpy(job->error, message);
+}
+
+// Verifica se a operação utiliza apenas a matriz X
+bool IsUnaryOperation(int operation)
+{
+    return operation == OPERATION_GAUSS_JORDAN ||
+           operation == OPERATION_TRANSPOSE ||
+           operation == OPERATION_POWER ||
+           operation == OPERATION_EXPONENTIAL;
+}
+
+// Multiplica a matrix X e a matriz Y
+void Multiply(Job *job, Task *task)
+{
+    if (job->columnsX != job->rowsY)
+    {
+        FailJob(job, "colunas X diferente de linhas Y");
+        return;
+    }
+
+    int size = job->columnsX;
+
+    int rows = job->rowsX;
+    int columns = job->columnsY;
+
+    double *z = AllocateJobResult(job, rows, columns);
+
+    // Nas precisões inteiras, o produto em double serve de referência para o erro
+    SetTaskStage(task, 0, job->precision == PRECISION_DOUBLE ? 1 : 0.5f);
+    StructuredMultiply(job->x, &job->structureX, job->y, &job->structureY, z, rows, size, columns, task);
+
+    job->precisionError = 0;
+
+    // O Z quantizado não é verificado: a tolerância do Freivalds é a do arredondamento em
+    // double, e o produto em double que ele verificaria não é o resultado entregue
+    if (job->verify && job->precision == PRECISION_DOUBLE && !IsTaskCancelled(task))
+    {
+        // Vetores diferentes a cada cálculo, para que um erro não passe sempre pelos mesmos
+        Random random;
+        SeedRandom(&random, (uint64_t)time(NULL) ^ (uint64_t)(uintptr_t)z);
+
+        job->verificationError = DenseFreivalds(job->x, job->y, z, rows, size, columns, FREIVALDS_TRIALS, &random);
+        job->verified = job->verificationError <= FREIVALDS_TOLERANCE * (size + columns) * DBL_EPSILON;
+    }
+
+    if (job->precision != PRECISION_DOUBLE)
+    {
+        int bits = job->precision == PRECISION_INT8 ? QNT_INT8 : QNT_INT16;
+
+        double *quantized = (double *)malloc(((size_t)rows * columns + 1) * sizeof(double));
+
+        SetTaskStage(task, 0.5f, 1);
+        MultiplyQuantized(job->x, job->y, quantized, rows, size, columns, bits, task);
+
+        job->precisionError = QuantizationError(quantized, z, rows * columns);
+
+        free(job->z);
+        job->z = quantized;
+    }
+
+    job->success = true;
+}
+
+// Adiciona (signal = 1) ou subtrai (signal = -1) a matriz Y da matriz X
+void AddScaled(Job *job, double signal)
+{
+    int rows = job->rowsX;
+    int columns = job->columnsX;
+
+    if (rows != job->rowsY || columns != job->columnsY)
+    {
+        FailJob(job, "tamanho X diferente de tamanho Y");
+        return;
+    }
+
+    double *z = AllocateJobResult(job, rows, columns);
+
+    for (size_t k = 0; k < (size_t)rows * columns; k++)
+    {
+        z[k] = job->x[k] + signal * job->y[k];
+    }
+
+    job->success = true;
+}
+
+// Adiciona a matrix X e a matriz Y
+void Add(Job *job)
+{
+    AddScaled(job, 1);
+}
+
+// Subtrai a matrix X e a matriz Y
+void Subtract(Job *job)
+{
+    AddScaled(job, -1);
+}
+
+// Troca os elementos de duas linhas da matriz z
+void SwapRows(double *z, int columns, int i1, int i2)
+{
+    for (int j = 0; j < columns; j++)
+    {
+        double temp = z[(size_t)i1 * columns + j];
+
+        z[(size_t)i1 * columns + j] = z[(size_t)i2 * columns + j];
+        z[(size_t)i2 * columns + j] = temp;
+    }
+}
+
+// Encontra a linha do pivo de uma coluna da matriz z, da linha row em diante
+// (isto é, a de maior valor absoluto, desde que acima de ZERO_THRESHOLD; -1 caso nenhuma)
+int SelectGaussianPivot(const double *z, int rows, int columns, int row, int column)
+{
+    int pivot = -1;
+    double largest = ZERO_THRESHOLD;
+
+    for (int i = row; i < rows; i++)
+    {
+        double magnitude = fabs(z[(size_t)i * columns + column]);
+
+        if (magnitude > largest)
+        {
+            pivot = i;
+            largest = magnitude;
+        }
+    }
+
+    return pivot;
+}
+
+// Elimina o pivo de todas as outras linhas da matriz z
+// As subtrações são registradas no trace, caso exista (as de coeficiente zero são omitidas)
+void EliminateGaussianPivot(double *z, int rows, int columns, int row, int pivot, Trace *trace = NULL)
+{
+    const double *source = z + (size_t)row * columns;
+
+    for (int i = 0; i < rows; i++)
+    {
+        if (i != row)
+        {
+            double *target = z + (size_t)i * columns;
+            double coefficient = target[pivot] / source[pivot];
+
+            if (coefficient != 0)
+                RecordTraceOperation(trace, z, TRC_AXPY, i, row, coefficient);
+
+            for (int j = 0; j < columns; j++)
+            {
+                target[j] -= coefficient * source[j];
+            }
+        }
+    }
+}
+
+// Redução da matriz X pelo método de Gauss Jordan
+void GaussJordan(Job *job, Task *task)
+{
+    int rows = job->rowsX;
+    int columns = job->columnsX;
+
+    double *z = AllocateJobResult(job, rows, columns);
+
+    memcpy(z, job->x, (size_t)rows * columns * sizeof(double));
+
+    // No modo exato, as matrizes inteiras são reduzidas em frações (sem o registro dos passos)
+    if (job->exact)
+    {
+        job->fractions = (Fraction *)malloc(((size_t)rows * columns + 1) * sizeof(Fraction));
+
+        if (ReduceExact(job->x, rows, columns, z, job->fractions, task))
+        {
+            job->success = true;
+            return;
+        }
+
+        free(job->fractions);
+        job->fractions = NULL;
+    }
+
+    Trace *trace = NULL;
+
+    if (job->traced)
+    {
+        trace = CreateTrace(z, rows, columns, (long long)rows * rows + 2 * rows);
+        job->trace = trace;
+    }
+
+    // Matrizes triangulares quadradas sem zeros na diagonal reduzem à identidade
+    // (exceto quando os passos são registrados, já que o atalho não tem passos)
+    if (trace == NULL && (HasStructure(&job->structureX, STR_UPPER) || HasStructure(&job->structureX, STR_LOWER)))
+    {
+        bool regular = true;
+
+        for (int k = 0; k < rows; k++)
+            regular = regular && fabs(job->x[(size_t)k * columns + k]) > ZERO_THRESHOLD;
+
+        if (regular)
+        {
+            DenseIdentity(z, rows);
+
+            job->success = true;
+            return;
+        }
+    }
+
+    // Forma escalonada reduzida: cada coluna com pivo ganha a próxima linha,
+    // que é normalizada e eliminada das demais; as colunas sem pivo são livres
+    int row = 0;
+
+    for (int column = 0; column < columns && row < rows && !IsTaskCancelled(task); column++)
+    {
+        int pivot = SelectGaussianPivot(z, rows, columns, row, column);
+
+        if (pivot != -1)
+        {
+            if (pivot != row)
+            {
+                RecordTraceOperation(trace, z, TRC_SWAP, row, pivot, 0);
+                SwapRows(z, columns, row, pivot);
+            }
+
+            double coefficient = z[(size_t)row * columns + column];
+
+            if (coefficient != 1)
+            {
+                RecordTraceOperation(trace, z, TRC_SCALE, row, row, coefficient);
+
+                for (int j = 0; j < columns; j++)
+                {
+                    z[(size_t)row * columns + j] /= coefficient;
+                }
+            }
+
+            EliminateGaussianPivot(z, rows, columns, row, column, trace);
+
+            row++;
+        }
+
+        SetTaskProgress(task, (float)(column + 1) / columns);
+    }
+
+    job->success = true;
+}
+
+// Transpõe a matriz X
+void Transpose(Job *job)
+{
+    int rows = job->rowsX;
+    int columns = job->columnsX;
+
+    // Matrizes quadradas são transpostas no próprio lugar, sobre a cópia de X
+    if (rows == columns)
+    {
+        DenseTranspose(job->x, job->x, rows, columns);
+
+        job->rowsZ = columns;
+        job->columnsZ = rows;
+        job->z = job->x;
+        job->x = NULL;
+    }
+    else
+    {
+        DenseTranspose(job->x, AllocateJobResult(job, columns, rows), rows, columns);
+    }
+
+    job->success = true;
+}
+
+// Eleva a matriz X ao expoente k por exponenciação binária
+void Power(Job *job, Task *task)
+{
+    if (job->rowsX != job->columnsX)
+    {
+        FailJob(job, "X nao e quadrada");
+        return;
+    }
+
+    int size = job->rowsX;
+    size_t count = (size_t)size * size + 1;
+
+    double *z = AllocateJobResult(job, size, size);
+    double *scratchA = (double *)malloc(count * sizeof(double));
+    double *scratchB = (double *)malloc(count * sizeof(double));
+
+    DensePower(job->x, z, scratchA, scratchB, size, job->exponent, task);
+
+    free(scratchA);
+    free(scratchB);
+
+    job->success = true;
+}
+
+// Calcula a exponencial da matriz X
+void Exponential(Job *job)
+{
+    if (job->rowsX != job->columnsX)
+    {
+        FailJob(job, "X nao e quadrada");
+        return;
+    }
+
+    int size = job->rowsX;
+
+    if (!DenseExponential(job->x, AllocateJobResult(job, size, size), size))
+    {
+        FailJob(job, "aproximante de Pade singular");
+        return;
+    }
+
+    job->success = true;
+}
+
+// Resolve o sistema x * z = y coluna por coluna pelos métodos de Krylov
+// O histórico guardado é o da coluna que exigiu mais iterações
+void SolveIterative(Job *job, Task *task)
+{
+    int size = job->rowsX;
+    int columns = job->columnsY;
+
+    const double *y = job->y;
+    double *z = job->z;
+
+    SparseMatrix sparse;
+    DenseToSparse(job->x, size, size, &sparse);
+
+    bool symmetric = HasStructure(&job->structureX, STR_SPD);
+
+    // Gradiente Conjugado exige um precondicionador simétrico, então usa Jacobi
+    int type = symmetric ? KRY_JACOBI : KRY_ILU0;
+
+    Preconditioner preconditioner;
+
+    if (!InitializePreconditioner(&preconditioner, &sparse, type))
+    {
+        FreePreconditioner(&preconditioner);
+        InitializePreconditioner(&preconditioner, &sparse, KRY_NONE);
+    }
+
+    sprintf(job->solveMethod, "%s + %s",
+            symmetric ? "CG" : "GMRES",
+            preconditioner.type == KRY_JACOBI ? "Jacobi" : preconditioner.type == KRY_ILU0 ? "ILU(0)" : "nenhum");
+
+    double *b = (double *)malloc(size * sizeof(double));
+    double *solution = (double *)malloc(size * sizeof(double));
+
+    KrylovHistory *history = (KrylovHistory *)malloc(sizeof(KrylovHistory));
+
+    job->solveHistory.iterations = 0;
+    job->solveHistory.converged = true;
+
+    for (int j = 0; j < columns && !IsTaskCancelled(task); j++)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            b[i] = y[(size_t)i * columns + j];
+            solution[i] = 0;
+        }
+
+        SetTaskStage(task, (float)j / columns, (float)(j + 1) / columns);
+
+        if (symmetric)
+            ConjugateGradient(&sparse, &preconditioner, b, solution, KRYLOV_TOLERANCE, KRYLOV_MAX_ITERATIONS, history, task);
+        else
+            Gmres(&sparse, &preconditioner, b, solution, KRYLOV_RESTART, KRYLOV_TOLERANCE, KRYLOV_MAX_ITERATIONS, history, task);
+
+        if (j == 0 || history->iterations > job->solveHistory.iterations || !history->converged)
+            job->solveHistory = *history;
+
+        for (int i = 0; i < size; i++)
+            z[(size_t)i * columns + j] = solution[i];
+    }
+
+    free(b);
+    free(solution);
+    free(history);
+
+    FreePreconditioner(&preconditioner);
+    FreeSparse(&sparse);
+}
+
+// Resolve o sistema X * Z = Y
+void Solve(Job *job, Task *task)
+{
+    if (job->rowsX != job->columnsX)
+    {
+        FailJob(job, "X nao e quadrada");
+        return;
+    }
+
+    if (job->rowsX != job->rowsY)
+    {
+        FailJob(job, "linhas X diferente de linhas Y");
+        return;
+    }
+
+    int size = job->rowsX;
+    int columns = job->columnsY;
+
+    double *z = AllocateJobResult(job, size, columns);
+
+    if (job->iterative)
+    {
+        SolveIterative(job, task);
+    }
+    else if (!StructuredSolve(job->x, &job->structureX, job->y, z, size, columns))
+    {
+        FailJob(job, "X singular");
+        return;
+    }
+
+    job->success = true;
+}
+
+// Calcula o resultado de um cálculo complexo
+// As precisões inteiras e a verificação de Freivalds valem apenas para o produto real
+void ExecuteComplexJob(Job *job, Task *task)
+{
+    job->precision = PRECISION_DOUBLE;
+    job->verify = false;
+
+    switch (job->operation)
+    {
+    case OPERATION_MULTIPLY:
+        if (job->columnsX != job->rowsY)
+        {
+            FailJob(job, "colunas X diferente de linhas Y");
+            return;
+        }
+
+        AllocateJobResult(job, job->rowsX, job->columnsY);
+        ComplexMultiply(job->x, job->xi, job->y, job->yi, job->z, AllocateJobImaginary(job), job->rowsX, job->columnsX, job->columnsY, task);
+        break;
+    case OPERATION_ADD:
+    case OPERATION_SUBTRACT:
+    {
+        double signal = job->operation == OPERATION_ADD ? 1 : -1;
+
+        AddScaled(job, signal);
+
+        if (!job->success)
+            return;
+
+        double *zi = AllocateJobImaginary(job);
+
+        for (size_t k = 0; k < (size_t)job->rowsZ * job->columnsZ; k++)
+            zi[k] = job->xi[k] + signal * job->yi[k];
+
+        break;
+    }
+    case OPERATION_GAUSS_JORDAN:
+        AllocateJobResult(job, job->rowsX, job->columnsX);
+        memcpy(job->z, job->x, (size_t)job->rowsX * job->columnsX * sizeof(double));
+        memcpy(AllocateJobImaginary(job), job->xi, (size_t)job->rowsX * job->columnsX * sizeof(double));
+
+        ComplexReduce(job->z, job->zi, job->rowsX, job->columnsX, ZERO_THRESHOLD, task);
+        break;
+    case OPERATION_TRANSPOSE:
+        DenseTranspose(job->x, AllocateJobResult(job, job->columnsX, job->rowsX), job->rowsX, job->columnsX);
+        DenseTranspose(job->xi, AllocateJobImaginary(job), job->rowsX, job->columnsX);
+        break;
+    case OPERATION_SOLVE:
+        if (job->rowsX != job->columnsX)
+        {
+            FailJob(job, "X nao e quadrada");
+            return;
+        }
+
+        if (job->rowsX != job->rowsY)
+        {
+            FailJob(job, "linhas X diferente de linhas Y");
+            return;
+        }
+
+        AllocateJobResult(job, job->rowsX, job->columnsY);
+
+        if (!ComplexSolve(job->x, job->xi, job->y, job->yi, job->z, AllocateJobImaginary(job), job->rowsX, job->columnsY))
+        {
+            FailJob(job, "X singular");
+            return;
+        }
+        break;
+    default:
+        FailJob(job, "operacao sem suporte a complexos");
+        return;
+    }
+
+    job->success = true;
+}
+
+// Calcula o resultado baseado na operação do cálculo
+void ExecuteJob(void *work, Task *task)
+{
+    Job *job = (Job *)work;
+
+    if (job->detectStructure)
+    {
+        DetectStructure(job->x, job->rowsX, job->columnsX, &job->structureX);
+        DetectStructure(job->y, job->rowsY, job->columnsY, &job->structureY);
+    }
+
+    if (job->complex)
+    {
+        ExecuteComplexJob(job, task);
+        return;
+    }
+
+    switch (job->operation)
+    {
+    case OPERATION_MULTIPLY:
+        Multiply(job, task);
+        break;
+    case OPERATION_ADD:
+        Add(job);
+        break;
+    case OPERATION_SUBTRACT:
+        Subtract(job);
+        break;
+    case OPERATION_GAUSS_JORDAN:
+        GaussJordan(job, task);
+        break;
+    case OPERATION_TRANSPOSE:
+        Transpose(job);
+        break;
+    case OPERATION_POWER:
+        Power(job, task);
+        break;
+    case OPERATION_EXPONENTIAL:
+        Exponential(job);
+        break;
+    case OPERATION_SOLVE:
+        Solve(job, task);
+        break;
+    }
+}
+
+#endif
@@ -0,0 +1,179 @@
+/*********************************************************************
+// Parallel.h
+// Divisão de laços entre várias threads. O intervalo é repartido em
+// blocos contíguos, um por thread, e a thread chamadora processa o
+// primeiro bloco enquanto as demais processam o restante. Algoritmos com
+// dependências irregulares montam um grafo de tarefas, executado por um
+// grupo de threads que retiram as tarefas prontas de uma fila de
+// prioridade.
+// *********************************************************************/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Quantidade de threads utilizadas (0 usa todos os núcleos disponíveis)
+int parallelThreads = 0;
+
+// Retorna a quantidade de threads que os laços paralelos utilizam
+int ParallelThreadCount()
+{
+    if (parallelThreads > 0)
+        return parallelThreads;
+
+    int count = (int)std::thread::hardware_concurrency();
+
+    return count > 0 ? count : 1;
+}
+
+// Executa function(first, last) sobre blocos de [begin, end) em paralelo
+// Intervalos com menos de 2 * grain iterações são executados na própria thread
+template <typename Function>
+void ParallelFor(int begin, int end, int grain, Function function)
+{
+    int count = end - begin;
+    int threadCount = ParallelThreadCount();
+
+    if (grain < 1)
+        grain = 1;
+
+    if (threadCount > count / grain)
+        threadCount = count / grain;
+
+    if (threadCount <= 1)
+    {
+        if (count > 0)
+            function(begin, end);
+
+        return;
+    }
+
+    std::vector<std::thread> threads;
+
+    for (int t = 1; t < threadCount; t++)
+    {
+        int first = begin + (int)((long long)count * t / threadCount);
+        int last = begin + (int)((long long)count * (t + 1) / threadCount);
+
+        threads.push_back(std::thread(function, first, last));
+    }
+
+    function(begin, begin + count / threadCount);
+
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+}
+
+// Nó do grafo de tarefas
+typedef struct
+{
+    std::function<void()> work;
+
+    // Menor valor é executado primeiro entre as tarefas prontas
+    int priority;
+
+    // Quantidade de predecessoras ainda não concluídas
+    int dependencies;
+    std::vector<int> successors;
+} GraphNode;
+
+typedef struct
+{
+    std::vector<GraphNode> nodes;
+} TaskGraph;
+
+// Acrescenta uma tarefa ao grafo e retorna seu índice
+int AddGraphNode(TaskGraph *graph, int priority, std::function<void()> work)
+{
+    GraphNode node;
+
+    node.work = work;
+    node.priority = priority;
+    node.dependencies = 0;
+
+    graph->nodes.push_back(node);
+
+    return (int)graph->nodes.size() - 1;
+}
+
+// Faz a tarefa after esperar pela conclusão da tarefa before
+void AddGraphDependency(TaskGraph *graph, int before, int after)
+{
+    graph->nodes[before].successors.push_back(after);
+    graph->nodes[after].dependencies++;
+}
+
+// Executa todas as tarefas do grafo respeitando as dependências, com até
+// ParallelThreadCount threads (a chamadora inclusive), e retorna quando todas terminam
+// Entre as tarefas prontas, a de menor prioridade e depois a de menor índice vem primeiro
+void RunGraph(TaskGraph *graph)
+{
+    typedef std::pair<int, int> Entry;
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > ready;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    int remaining = (int)graph->nodes.size();
+
+    for (size_t k = 0; k < graph->nodes.size(); k++)
+    {
+        if (graph->nodes[k].dependencies == 0)
+            ready.push(Entry(graph->nodes[k].priority, (int)k));
+    }
+
+    auto worker = [&]()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true)
+        {
+            condition.wait(lock, [&]() { return !ready.empty() || remaining == 0; });
+
+            if (remaining == 0)
+                break;
+
+            GraphNode *node = &graph->nodes[ready.top().second];
+            ready.pop();
+
+            lock.unlock();
+            node->work();
+            lock.lock();
+
+            remaining--;
+
+            for (size_t s = 0; s < node->successors.size(); s++)
+            {
+                GraphNode *successor = &graph->nodes[node->successors[s]];
+
+                if (--successor->dependencies == 0)
+                    ready.push(Entry(successor->priority, node->successors[s]));
+            }
+
+            condition.notify_all();
+        }
+    };
+
+    int threadCount = ParallelThreadCount();
+
+    if (threadCount > remaining)
+        threadCount = remaining;
+
+    std::vector<std::thread> threads;
+
+    for (int t = 1; t < threadCount; t++)
+        threads.push_back(std::thread(worker));
+
+    worker();
+
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+}
+
+#endif
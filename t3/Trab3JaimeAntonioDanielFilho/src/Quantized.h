@@ -0,0 +1,230 @@
+/*********************************************************************
+// Quantized.h
+// Multiplicação aproximada de matrizes com elementos quantizados em
+// inteiros de 8 ou 16 bits. As linhas de X e as colunas de Y possuem
+// escalas próprias, os produtos são somados aos pares pela instrução
+// pmaddwd (SSE2) e acumulados em inteiros de 32 bits (8 bits) ou de 64
+// bits no próprio registrador (16 bits), e o resultado é convertido de
+// volta para double.
+// *********************************************************************/
+
+#ifndef QUANTIZED_H
+#define QUANTIZED_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Task.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define QNT_INT8 8
+#define QNT_INT16 16
+
+// Quantidade de elementos de 8 bits somados nos acumuladores de 32 bits
+// antes de transferi-los para 64 bits, garantindo que não ocorra overflow
+#define QNT_INT8_BLOCK 4096
+
+// Arredonda o tamanho para um múltiplo de 8 (largura de um registrador SSE)
+int QuantizedStride(int size)
+{
+    return (size + 7) & ~7;
+}
+
+// Maior valor absoluto representável com tal quantidade de bits
+int QuantizedLimit(int bits)
+{
+    return bits == QNT_INT8 ? 127 : 32767;
+}
+
+// Calcula a escala que leva o maior valor absoluto do vetor até o limite
+double QuantizedScale(const double *values, int count, int step, int limit)
+{
+    double maximum = 0;
+
+    for (int k = 0; k < count; k++)
+    {
+        if (fabs(values[k * step]) > maximum)
+            maximum = fabs(values[k * step]);
+    }
+
+    return maximum > 0 ? maximum / limit : 1;
+}
+
+// Quantiza um vetor (com passo arbitrário) para inteiros de 8 bits
+void QuantizeInt8(const double *values, int count, int step, double scale, int8_t *destination)
+{
+    for (int k = 0; k < count; k++)
+        destination[k] = (int8_t)lround(values[k * step] / scale);
+}
+
+// Quantiza um vetor (com passo arbitrário) para inteiros de 16 bits
+void QuantizeInt16(const double *values, int count, int step, double scale, int16_t *destination)
+{
+    for (int k = 0; k < count; k++)
+        destination[k] = (int16_t)lround(values[k * step] / scale);
+}
+
+// Produto escalar de dois vetores de 8 bits com comprimento múltiplo de 8
+int64_t DotInt8(const int8_t *a, const int8_t *b, int length)
+{
+    int64_t total = 0;
+
+    for (int start = 0; start < length; start += QNT_INT8_BLOCK)
+    {
+        int end = start + QNT_INT8_BLOCK < length ? start + QNT_INT8_BLOCK : length;
+
+#ifdef __SSE2__
+        __m128i accumulator = _mm_setzero_si128();
+
+        for (int k = start; k < end; k += 8)
+        {
+            __m128i va = _mm_loadl_epi64((const __m128i *)(a + k));
+            __m128i vb = _mm_loadl_epi64((const __m128i *)(b + k));
+
+            // Estende o sinal dos bytes para 16 bits
+            va = _mm_srai_epi16(_mm_unpacklo_epi8(va, va), 8);
+            vb = _mm_srai_epi16(_mm_unpacklo_epi8(vb, vb), 8);
+
+            accumulator = _mm_add_epi32(accumulator, _mm_madd_epi16(va, vb));
+        }
+
+        int32_t lanes[4];
+        _mm_storeu_si128((__m128i *)lanes, accumulator);
+
+        total += (int64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#else
+        int32_t accumulator = 0;
+
+        for (int k = start; k < end; k++)
+            accumulator += (int32_t)a[k] * b[k];
+
+        total += accumulator;
+#endif
+    }
+
+    return total;
+}
+
+// Produto escalar de dois vetores de 16 bits com comprimento múltiplo de 8
+// Cada par de produtos cabe em 32 bits (os valores vão até 32767), mas dois
+// pares já não cabem, então cada pista do pmaddwd é estendida para 64 bits
+int64_t DotInt16(const int16_t *a, const int16_t *b, int length)
+{
+#ifdef __SSE2__
+    __m128i accumulator = _mm_setzero_si128();
+
+    for (int k = 0; k < length; k += 8)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + k));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + k));
+
+        __m128i pairs = _mm_madd_epi16(va, vb);
+        __m128i sign = _mm_srai_epi32(pairs, 31);
+
+        // Intercala cada pista com o seu sinal, formando os inteiros de 64 bits
+        accumulator = _mm_add_epi64(accumulator, _mm_unpacklo_epi32(pairs, sign));
+        accumulator = _mm_add_epi64(accumulator, _mm_unpackhi_epi32(pairs, sign));
+    }
+
+    int64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, accumulator);
+
+    return lanes[0] + lanes[1];
+#else
+    int64_t total = 0;
+
+    for (int k = 0; k < length; k += 2)
+        total += (int32_t)a[k] * b[k] + (int32_t)a[k + 1] * b[k + 1];
+
+    return total;
+#endif
+}
+
+// Multiplica as matrizes x (rows x size) e y (size x columns) quantizadas
+// com tal quantidade de bits, escrevendo o resultado aproximado em z
+void MultiplyQuantized(const double *x, const double *y, double *z, int rows, int size, int columns, int bits, Task *task = NULL)
+{
+    int stride = QuantizedStride(size);
+    int limit = QuantizedLimit(bits);
+    int width = bits == QNT_INT8 ? 1 : 2;
+
+    double *rowScales = (double *)malloc(rows * sizeof(double));
+    double *columnScales = (double *)malloc(columns * sizeof(double));
+
+    // As colunas de Y são armazenadas contíguas para que ambos os operandos sejam lidos em sequência
+    char *packedX = (char *)calloc((size_t)rows * stride, width);
+    char *packedY = (char *)calloc((size_t)columns * stride, width);
+
+    for (int i = 0; i < rows; i++)
+    {
+        rowScales[i] = QuantizedScale(x + i * size, size, 1, limit);
+
+        if (bits == QNT_INT8)
+            QuantizeInt8(x + i * size, size, 1, rowScales[i], (int8_t *)packedX + (size_t)i * stride);
+        else
+            QuantizeInt16(x + i * size, size, 1, rowScales[i], (int16_t *)packedX + (size_t)i * stride);
+    }
+
+    for (int j = 0; j < columns; j++)
+    {
+        columnScales[j] = QuantizedScale(y + j, size, columns, limit);
+
+        if (bits == QNT_INT8)
+            QuantizeInt8(y + j, size, columns, columnScales[j], (int8_t *)packedY + (size_t)j * stride);
+        else
+            QuantizeInt16(y + j, size, columns, columnScales[j], (int16_t *)packedY + (size_t)j * stride);
+    }
+
+    for (int i = 0; i < rows && !IsTaskCancelled(task); i++)
+    {
+        for (int j = 0; j < columns; j++)
+        {
+            int64_t accumulator;
+
+            if (bits == QNT_INT8)
+            {
+                accumulator = DotInt8(
+                    (int8_t *)packedX + (size_t)i * stride,
+                    (int8_t *)packedY + (size_t)j * stride,
+                    stride);
+            }
+            else
+            {
+                accumulator = DotInt16(
+                    (int16_t *)packedX + (size_t)i * stride,
+                    (int16_t *)packedY + (size_t)j * stride,
+                    stride);
+            }
+
+            z[i * columns + j] = accumulator * rowScales[i] * columnScales[j];
+        }
+
+        SetTaskProgress(task, (float)(i + 1) / rows);
+    }
+
+    free(rowScales);
+    free(columnScales);
+    free(packedX);
+    free(packedY);
+}
+
+// Calcula o maior erro absoluto entre o resultado aproximado e o exato
+double QuantizationError(const double *approximate, const double *exact, int count)
+{
+    double error = 0;
+
+    for (int k = 0; k < count; k++)
+    {
+        if (fabs(approximate[k] - exact[k]) > error)
+            error = fabs(approximate[k] - exact[k]);
+    }
+
+    return error;
+}
+
+#endif
@@ -0,0 +1,275 @@
+/*********************************************************************
+// Random.h
+// Gerador de números pseudoaleatórios xoshiro256** com quatro fluxos
+// intercalados, de forma que o preenchimento em lote processe quatro
+// valores por passo e possa ser vetorizado pelo compilador. Cada gerador
+// pode ser semeado para entradas reproduzíveis e saltar 2^128 posições
+// adiante, fornecendo fluxos independentes para cada thread.
+// *********************************************************************/
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <math.h>
+#include <stdint.h>
+
+#include "Parallel.h"
+
+#define RND_LANES 4
+
+// Quantidade mínima de valores gerados por thread nos preenchimentos paralelos
+#define RND_PARALLEL_GRAIN 65536
+
+typedef struct
+{
+    // Estado de cada fluxo armazenado por palavra, para acesso contíguo às quatro pistas
+    uint64_t state[4][RND_LANES];
+
+    // Valores já gerados e ainda não consumidos pelas funções escalares
+    uint64_t buffer[RND_LANES];
+    int available;
+} Random;
+
+// Gerador global utilizado pela interface
+Random globalRandom;
+
+// Avança o estado do splitmix64, usado apenas para expandir a semente
+uint64_t SplitMix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return z ^ (z >> 31);
+}
+
+// Rotaciona os bits de x para a esquerda
+uint64_t RotateLeft(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// Gera os próximos valores das quatro pistas
+void NextRandomLanes(Random *random, uint64_t *destination)
+{
+    uint64_t (*s)[RND_LANES] = random->state;
+
+    for (int l = 0; l < RND_LANES; l++)
+    {
+        destination[l] = RotateLeft(s[1][l] * 5, 7) * 9;
+
+        uint64_t t = s[1][l] << 17;
+
+        s[2][l] ^= s[0][l];
+        s[3][l] ^= s[1][l];
+        s[1][l] ^= s[2][l];
+        s[0][l] ^= s[3][l];
+
+        s[2][l] ^= t;
+        s[3][l] = RotateLeft(s[3][l], 45);
+    }
+}
+
+// Salta 2^128 passos em uma única pista (equivale a 2^128 chamadas)
+void JumpRandomLane(Random *random, int lane)
+{
+    static const uint64_t jump[] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+
+    uint64_t s[4];
+    uint64_t result[4] = {0, 0, 0, 0};
+
+    for (int i = 0; i < 4; i++)
+        s[i] = random->state[i][lane];
+
+    for (int i = 0; i < 4; i++)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            if (jump[i] & ((uint64_t)1 << b))
+            {
+                for (int k = 0; k < 4; k++)
+                    result[k] ^= s[k];
+            }
+
+            uint64_t t = s[1] << 17;
+
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+
+            s[2] ^= t;
+            s[3] = RotateLeft(s[3], 45);
+        }
+    }
+
+    for (int i = 0; i < 4; i++)
+        random->state[i][lane] = result[i];
+}
+
+// Salta todas as pistas adiante, gerando um fluxo independente do original
+void JumpRandom(Random *random)
+{
+    // Cada pista já ocupa um trecho de 2^128 valores, então o gerador avança 4 trechos.
+    // As pistas andam juntas a um salto de distância, então a nova primeira pista é a
+    // última saltada uma vez e cada uma das outras, a anterior saltada uma vez
+    for (int i = 0; i < 4; i++)
+        random->state[i][0] = random->state[i][RND_LANES - 1];
+
+    JumpRandomLane(random, 0);
+
+    for (int l = 1; l < RND_LANES; l++)
+    {
+        for (int i = 0; i < 4; i++)
+            random->state[i][l] = random->state[i][l - 1];
+
+        JumpRandomLane(random, l);
+    }
+
+    random->available = 0;
+}
+
+// Semeia o gerador. As pistas ficam separadas por saltos de 2^128 posições
+void SeedRandom(Random *random, uint64_t seed)
+{
+    for (int i = 0; i < 4; i++)
+        random->state[i][0] = SplitMix64(&seed);
+
+    for (int l = 1; l < RND_LANES; l++)
+    {
+        for (int i = 0; i < 4; i++)
+            random->state[i][l] = random->state[i][l - 1];
+
+        JumpRandomLane(random, l);
+    }
+
+    random->available = 0;
+}
+
+// Retorna um inteiro aleatório de 64 bits
+uint64_t NextRandom(Random *random)
+{
+    if (random->available == 0)
+    {
+        NextRandomLanes(random, random->buffer);
+        random->available = RND_LANES;
+    }
+
+    return random->buffer[--random->available];
+}
+
+// Converte 64 bits aleatórios em um inteiro uniforme em [0, range) pelo método
+// de Lemire, rejeitando os poucos valores que causariam viés
+uint64_t BoundedRandom(Random *random, uint64_t value, uint64_t range)
+{
+    unsigned __int128 product = (unsigned __int128)value * range;
+    uint64_t low = (uint64_t)product;
+
+    if (low < range)
+    {
+        uint64_t threshold = -range % range;
+
+        while (low < threshold)
+        {
+            product = (unsigned __int128)NextRandom(random) * range;
+            low = (uint64_t)product;
+        }
+    }
+
+    return (uint64_t)(product >> 64);
+}
+
+// Converte 64 bits aleatórios em um double uniforme em [0, 1)
+double UnitRandom(uint64_t value)
+{
+    return (value >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Preenche o array com inteiros uniformes em [minimum, maximum]
+void FillRandomIntegers(Random *random, double *destination, long long count, int minimum, int maximum)
+{
+    uint64_t range = (uint64_t)((long long)maximum - minimum + 1);
+    uint64_t values[RND_LANES];
+
+    for (long long k = 0; k < count; k += RND_LANES)
+    {
+        NextRandomLanes(random, values);
+
+        for (int l = 0; l < RND_LANES && k + l < count; l++)
+            destination[k + l] = minimum + (long long)BoundedRandom(random, values[l], range);
+    }
+}
+
+// Preenche o array com reais uniformes em [minimum, maximum)
+void FillRandomReals(Random *random, double *destination, long long count, double minimum, double maximum)
+{
+    uint64_t values[RND_LANES];
+
+    for (long long k = 0; k < count; k += RND_LANES)
+    {
+        NextRandomLanes(random, values);
+
+        for (int l = 0; l < RND_LANES && k + l < count; l++)
+            destination[k + l] = minimum + (maximum - minimum) * UnitRandom(values[l]);
+    }
+}
+
+// Preenche o array com valores da distribuição normal pelo método de Box-Muller
+void FillRandomNormals(Random *random, double *destination, long long count, double mean, double deviation)
+{
+    uint64_t values[RND_LANES];
+
+    for (long long k = 0; k < count; k += RND_LANES)
+    {
+        NextRandomLanes(random, values);
+
+        for (int l = 0; l < RND_LANES; l += 2)
+        {
+            double radius = sqrt(-2 * log(1 - UnitRandom(values[l])));
+            double angle = 6.28318530717958647692 * UnitRandom(values[l + 1]);
+
+            if (k + l < count)
+                destination[k + l] = mean + deviation * radius * cos(angle);
+
+            if (k + l + 1 < count)
+                destination[k + l + 1] = mean + deviation * radius * sin(angle);
+        }
+    }
+}
+
+// Preenche um array grande em paralelo: cada thread recebe uma cópia do gerador
+// avançada por saltos, de forma que os fluxos nunca se sobreponham. O resultado
+// depende apenas da semente e do tamanho dos blocos, não da quantidade de threads
+template <typename Fill>
+void FillRandomParallel(Random *random, double *destination, long long count, Fill fill)
+{
+    int blocks = (int)((count + RND_PARALLEL_GRAIN - 1) / RND_PARALLEL_GRAIN);
+
+    Random base = *random;
+
+    ParallelFor(0, blocks, 1, [&](int first, int last)
+    {
+        Random stream = base;
+
+        for (int b = 0; b < first; b++)
+            JumpRandom(&stream);
+
+        for (int b = first; b < last; b++)
+        {
+            long long start = (long long)b * RND_PARALLEL_GRAIN;
+            long long length = count - start < RND_PARALLEL_GRAIN ? count - start : RND_PARALLEL_GRAIN;
+
+            Random block = stream;
+            fill(&block, destination + start, length);
+
+            JumpRandom(&stream);
+        }
+    });
+
+    // O gerador original continua depois de todos os fluxos utilizados
+    for (int b = 0; b < blocks; b++)
+        JumpRandom(random);
+}
+
+#endif
@@ -0,0 +1,431 @@
+/*********************************************************************
+// Rational.h
+// Redução exata de matrizes inteiras à forma escalonada reduzida, com o
+// resultado em frações. A eliminação é livre de frações (Bareiss): cada
+// passo combina a linha do pivo com as demais e divide o resultado pelo
+// pivo anterior, divisão que é sempre exata, então todos os valores
+// intermediários são inteiros. Eles ficam em 64 bits enquanto cabem, com
+// os produtos em 128 bits e a divisão trocada pela multiplicação pelo
+// inverso do pivo anterior. No primeiro valor que não cabe, a eliminação
+// continua do mesmo passo com os inteiros de BigInt.h. Ao final, cada
+// elemento é dividido pelo último pivo e a fração é reduzida pelo mdc.
+// *********************************************************************/
+
+#ifndef RATIONAL_H
+#define RATIONAL_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "BigInt.h"
+#include "Modular.h"
+#include "Task.h"
+
+// Fração irredutível com o denominador positivo
+// O denominador zero indica um valor que não cabe em 64 bits, do qual resta apenas o double
+typedef struct
+{
+    int64_t numerator, denominator;
+} Fraction;
+
+// Calcula o máximo divisor comum das magnitudes de dois inteiros pelo algoritmo binário
+uint64_t GreatestCommonDivisor(uint64_t a, uint64_t b)
+{
+    if (a == 0 || b == 0)
+        return a | b;
+
+    int shift = __builtin_ctzll(a | b);
+
+    a >>= __builtin_ctzll(a);
+
+    // O menor fica em a e a diferença em b, sem desvios que dependam dos valores
+    while (b != 0)
+    {
+        b >>= __builtin_ctzll(b);
+
+        uint64_t difference = b - a;
+
+        a = a < b ? a : b;
+        b = (int64_t)difference < 0 ? 0 - difference : difference;
+    }
+
+    return a << shift;
+}
+
+// Monta a fração irredutível numerator / denominator (denominador diferente de zero)
+// Os valores nunca são INT64_MIN, que a eliminação trata como fora dos 64 bits
+Fraction MakeFraction(int64_t numerator, int64_t denominator)
+{
+    if (denominator < 0)
+    {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+
+    uint64_t magnitude = numerator < 0 ? 0 - (uint64_t)numerator : (uint64_t)numerator;
+    int64_t divisor = (int64_t)GreatestCommonDivisor(magnitude, (uint64_t)denominator);
+
+    Fraction fraction;
+    fraction.numerator = numerator / divisor;
+    fraction.denominator = denominator / divisor;
+
+    return fraction;
+}
+
+// Verifica se todos os elementos são inteiros exatos no double
+bool IsIntegerMatrix(const double *elements, size_t count)
+{
+    for (size_t k = 0; k < count; k++)
+    {
+        if (elements[k] != floor(elements[k]) || fabs(elements[k]) >= MOD_MAX_EXACT)
+            return false;
+    }
+
+    return true;
+}
+
+// Calcula o inverso de um número ímpar módulo 2^64
+// Cada iteração de Newton dobra os bits corretos (3 bits corretos de início)
+uint64_t InverseModulo64(uint64_t odd)
+{
+    uint64_t inverse = odd;
+
+    for (int k = 0; k < 5; k++)
+        inverse *= 2 - odd * inverse;
+
+    return inverse;
+}
+
+// Encontra a primeira linha, de row em diante, com um elemento não nulo na coluna (-1 caso nenhuma)
+int SelectExactPivot(const int64_t *a, int rows, int columns, int row, int column)
+{
+    for (int i = row; i < rows; i++)
+    {
+        if (a[(size_t)i * columns + column] != 0)
+            return i;
+    }
+
+    return -1;
+}
+
+// Calcula o OU das magnitudes dos elementos, cujo bit mais alto limita todos eles
+uint64_t MagnitudeBits(const int64_t *a, size_t count)
+{
+    uint64_t bits = 0;
+
+    for (size_t k = 0; k < count; k++)
+        bits |= a[k] < 0 ? 0 - (uint64_t)a[k] : (uint64_t)a[k];
+
+    return bits;
+}
+
+// O mesmo passo de EliminateExact64 quando todos os valores de a têm menos de 31 bits:
+// os produtos e a diferença cabem em 64 bits e o quociente não passa do dividendo,
+// então não há verificação alguma
+void EliminateNarrow64(const int64_t *a, int64_t *b, int rows, int columns, int row, int column, int64_t previous)
+{
+    const int64_t *source = a + (size_t)row * columns;
+    int64_t pivot = source[column];
+
+    uint64_t magnitude = previous < 0 ? 0 - (uint64_t)previous : (uint64_t)previous;
+    int shift = __builtin_ctzll(magnitude);
+    uint64_t inverse = InverseModulo64((uint64_t)(previous >> shift));
+
+    memcpy(b + (size_t)row * columns, source, columns * sizeof(int64_t));
+
+    for (int i = 0; i < rows; i++)
+    {
+        if (i == row)
+            continue;
+
+        const int64_t *target = a + (size_t)i * columns;
+        int64_t *destination = b + (size_t)i * columns;
+        int64_t coefficient = target[column];
+
+        for (int j = 0; j < columns; j++)
+        {
+            int64_t dividend = pivot * target[j] - coefficient * source[j];
+            destination[j] = (int64_t)((uint64_t)(dividend >> shift) * inverse);
+        }
+    }
+}
+
+// Um passo da eliminação livre de frações sobre inteiros de 64 bits, lendo de a e escrevendo em b:
+// b_ij = (a_rc * a_ij - a_ic * a_rj) / previous para as linhas i diferentes de row (r) e a linha row copiada
+// A linha row é nula antes da coluna column, onde basta b_ij = a_rc * a_ij / previous
+// A divisão exata vira um deslocamento pelos bits nulos de previous seguido do produto pelo inverso
+// da sua parte ímpar; o quociente só é aceito se multiplicado por previous voltar ao dividendo
+// Retorna falso caso algum valor não caiba em 64 bits
+bool EliminateExact64(const int64_t *a, int64_t *b, int rows, int columns, int row, int column, int64_t previous)
+{
+    const int64_t *source = a + (size_t)row * columns;
+    int64_t pivot = source[column];
+
+    uint64_t magnitude = previous < 0 ? 0 - (uint64_t)previous : (uint64_t)previous;
+    int shift = __builtin_ctzll(magnitude);
+    uint64_t inverse = InverseModulo64((uint64_t)(previous >> shift));
+
+    memcpy(b + (size_t)row * columns, source, columns * sizeof(int64_t));
+
+    for (int i = 0; i < rows; i++)
+    {
+        if (i == row)
+            continue;
+
+        const int64_t *target = a + (size_t)i * columns;
+        int64_t *destination = b + (size_t)i * columns;
+        int64_t coefficient = target[column];
+
+        bool fits = true;
+
+        for (int j = 0; j < column; j++)
+        {
+            __int128 dividend = (__int128)pivot * target[j];
+            int64_t quotient = (int64_t)((uint64_t)(dividend >> shift) * inverse);
+
+            fits &= ((__int128)quotient * previous == dividend) & (quotient != INT64_MIN);
+            destination[j] = quotient;
+        }
+
+        for (int j = column; j < columns; j++)
+        {
+            __int128 dividend = (__int128)pivot * target[j] - (__int128)coefficient * source[j];
+            int64_t quotient = (int64_t)((uint64_t)(dividend >> shift) * inverse);
+
+            fits &= ((__int128)quotient * previous == dividend) & (quotient != INT64_MIN);
+            destination[j] = quotient;
+        }
+
+        if (!fits)
+            return false;
+    }
+
+    return true;
+}
+
+// Troca duas linhas de uma matriz de inteiros de 64 bits
+void SwapExactRows(int64_t *a, int columns, int i1, int i2)
+{
+    for (int j = 0; j < columns; j++)
+    {
+        int64_t temp = a[(size_t)i1 * columns + j];
+
+        a[(size_t)i1 * columns + j] = a[(size_t)i2 * columns + j];
+        a[(size_t)i2 * columns + j] = temp;
+    }
+}
+
+// Continua a eliminação com inteiros de tamanho arbitrário a partir do estado de 64 bits,
+// da coluna column e da linha row em diante (sendo last o último pivo), e escreve as frações do resultado
+// Retorna falso caso a tarefa seja cancelada
+bool ReduceExactBig(const int64_t *state, int rows, int columns, int row, int column, int64_t last, double *z, Fraction *fractions, Task *task)
+{
+    size_t count = (size_t)rows * columns;
+
+    BigInt *a = (BigInt *)malloc((count + 1) * sizeof(BigInt));
+    BigInt *b = (BigInt *)malloc((count + 1) * sizeof(BigInt));
+
+    for (size_t k = 0; k < count; k++)
+    {
+        InitializeBigInt(&a[k]);
+        InitializeBigInt(&b[k]);
+
+        SetBigInt(&a[k], state[k]);
+    }
+
+    BigInt previous, product, term;
+
+    InitializeBigInt(&previous);
+    InitializeBigInt(&product);
+    InitializeBigInt(&term);
+
+    SetBigInt(&previous, last);
+
+    for (; column < columns && row < rows && !IsTaskCancelled(task); column++)
+    {
+        int pivot = -1;
+
+        for (int i = row; i < rows && pivot == -1; i++)
+        {
+            if (a[(size_t)i * columns + column].sign != 0)
+                pivot = i;
+        }
+
+        if (pivot == -1)
+            continue;
+
+        for (int j = 0; j < columns && pivot != row; j++)
+        {
+            BigInt temp = a[(size_t)row * columns + j];
+
+            a[(size_t)row * columns + j] = a[(size_t)pivot * columns + j];
+            a[(size_t)pivot * columns + j] = temp;
+        }
+
+        const BigInt *source = a + (size_t)row * columns;
+
+        for (int i = 0; i < rows && !IsTaskCancelled(task); i++)
+        {
+            BigInt *target = a + (size_t)i * columns;
+            BigInt *destination = b + (size_t)i * columns;
+
+            for (int j = 0; j < columns; j++)
+            {
+                if (i == row)
+                {
+                    CopyBigInt(&destination[j], &source[j]);
+                    continue;
+                }
+
+                MultiplyBigInt(&product, &source[column], &target[j]);
+                MultiplyBigInt(&term, &target[column], &source[j]);
+                AccumulateBigInt(&product, &term, -1);
+
+                DivideBigIntExact(&destination[j], &product, &previous);
+            }
+        }
+
+        BigInt *temp = a;
+        a = b;
+        b = temp;
+
+        CopyBigInt(&previous, &a[(size_t)row * columns + column]);
+        row++;
+
+        SetTaskProgress(task, (float)(column + 1) / columns);
+    }
+
+    bool finished = !IsTaskCancelled(task);
+
+    // Cada elemento dividido pelo último pivo, reduzido pelo mdc
+    for (size_t k = 0; k < count && finished; k++)
+    {
+        BigInt *numerator = &a[k];
+
+        if (numerator->sign == 0)
+        {
+            z[k] = 0;
+            fractions[k].numerator = 0;
+            fractions[k].denominator = 1;
+            continue;
+        }
+
+        GreatestCommonDivisorBigInt(&term, numerator, &previous);
+
+        DivideBigIntExact(&product, numerator, &term);
+        DivideBigIntExact(numerator, &previous, &term);
+
+        // numerator guarda agora o denominador, com o sinal levado para o numerador
+        product.sign *= numerator->sign;
+        numerator->sign = 1;
+
+        z[k] = BigIntRatio(&product, numerator);
+
+        if (!BigIntToInt64(&product, &fractions[k].numerator) || !BigIntToInt64(numerator, &fractions[k].denominator))
+            fractions[k].denominator = 0;
+    }
+
+    for (size_t k = 0; k < count; k++)
+    {
+        FreeBigInt(&a[k]);
+        FreeBigInt(&b[k]);
+    }
+
+    free(a);
+    free(b);
+
+    FreeBigInt(&previous);
+    FreeBigInt(&product);
+    FreeBigInt(&term);
+
+    return finished;
+}
+
+// Reduz a matriz inteira (rows x columns) à forma escalonada reduzida exata, com as
+// frações em fractions e seus valores em z
+// Retorna falso caso algum elemento não seja inteiro ou a tarefa seja cancelada
+bool ReduceExact(const double *elements, int rows, int columns, double *z, Fraction *fractions, Task *task = NULL)
+{
+    size_t count = (size_t)rows * columns;
+
+    if (!IsIntegerMatrix(elements, count))
+        return false;
+
+    int64_t *a = (int64_t *)malloc((count + 1) * sizeof(int64_t));
+    int64_t *b = (int64_t *)malloc((count + 1) * sizeof(int64_t));
+
+    for (size_t k = 0; k < count; k++)
+        a[k] = (int64_t)elements[k];
+
+    int64_t previous = 1;
+    int row = 0, column = 0;
+
+    bool overflow = false;
+
+    for (; column < columns && row < rows && !IsTaskCancelled(task); column++)
+    {
+        int pivot = SelectExactPivot(a, rows, columns, row, column);
+
+        if (pivot == -1)
+            continue;
+
+        if (pivot != row)
+            SwapExactRows(a, columns, row, pivot);
+
+        // O passo é refeito do início em BigInt, já que a continua intacto
+        if (MagnitudeBits(a, count) < ((uint64_t)1 << 31))
+        {
+            EliminateNarrow64(a, b, rows, columns, row, column, previous);
+        }
+        else if (!EliminateExact64(a, b, rows, columns, row, column, previous))
+        {
+            overflow = true;
+            break;
+        }
+
+        int64_t *temp = a;
+        a = b;
+        b = temp;
+
+        previous = a[(size_t)row * columns + column];
+        row++;
+
+        SetTaskProgress(task, (float)(column + 1) / columns);
+    }
+
+    bool finished;
+
+    if (overflow)
+    {
+        finished = ReduceExactBig(a, rows, columns, row, column, previous, z, fractions, task);
+    }
+    else
+    {
+        finished = !IsTaskCancelled(task);
+
+        for (size_t k = 0; k < count && finished; k++)
+        {
+            fractions[k] = MakeFraction(a[k], previous);
+            z[k] = (double)fractions[k].numerator / fractions[k].denominator;
+        }
+    }
+
+    free(a);
+    free(b);
+
+    return finished;
+}
+
+// Escreve a fração (por exemplo "-3/4", ou "5" quando inteira) e retorna o tamanho do texto
+int PrintFraction(const Fraction *fraction, char *text, int capacity)
+{
+    if (fraction->denominator == 1)
+        return snprintf(text, capacity, "%lld", (long long)fraction->numerator);
+
+    return snprintf(text, capacity, "%lld/%lld", (long long)fraction->numerator, (long long)fraction->denominator);
+}
+
+#endif
@@ -0,0 +1,842 @@
+/*********************************************************************
+// Server.h
+// Modo servidor (somente Linux): um processo sem interface que recebe
+// cálculos de outros programas por um socket Unix local. As matrizes não
+// passam pelo socket: o cliente já cria X e Y em memória compartilhada
+// (memfd) e envia apenas os descritores, que o servidor mapeia sem cópia;
+// o resultado volta da mesma forma e o cliente o lê no próprio buffer. Os pedidos esperam em uma fila com
+// prioridades e são executados um por vez (as rotinas numéricas já usam
+// todos os núcleos). Um cliente que fecha a conexão cancela os seus
+// pedidos, inclusive o que estiver em execução.
+// *********************************************************************/
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Operations.h"
+#include "Structure.h"
+#include "Task.h"
+
+#define SRV_SOCKET_PATH "/tmp/the-matrix.sock"
+
+#define SRV_MAGIC 0x5854414Du
+
+#define SRV_MAX_QUEUE 256
+#define SRV_MAX_CONNECTIONS 64
+
+// Prioridade dos pedidos feitos pela interface, acima da padrão (0)
+#define SRV_PRIORITY_INTERACTIVE 10
+
+// Intervalo (ms) em que o cliente verifica o cancelamento enquanto espera o resultado
+#define SRV_POLL_INTERVAL 50
+
+// Pedido de cálculo, enviado com os descritores das matrizes X e Y
+typedef struct
+{
+    uint32_t magic;
+    int32_t priority;
+
+    int32_t operation, precision, iterative, verify;
+    uint32_t exponent;
+
+    int32_t rowsX, columnsX;
+    int32_t rowsY, columnsY;
+} ServerRequest;
+
+// Resposta de um pedido, enviada com o descritor da matriz Z em caso de sucesso
+typedef struct
+{
+    uint32_t magic;
+    int32_t success;
+
+    int32_t rowsZ, columnsZ;
+
+    double precisionError;
+    char error[100];
+
+    int32_t verified;
+    double verificationError;
+
+    // Cliente e servidor são o mesmo programa, então o histórico segue como está na memória
+    KrylovHistory solveHistory;
+    char solveMethod[32];
+} ServerResponse;
+
+// Pedido na fila do servidor
+typedef struct
+{
+    Job *job;
+    Task task;
+
+    int priority;
+    unsigned long long sequence;
+
+    // Cópia do descritor da conexão, usada apenas para a resposta
+    int reply;
+
+    // Mapeamentos das entradas, desfeitos ao final do pedido
+    void *mappings[2];
+    size_t sizes[2];
+} ServerJob;
+
+// Memória compartilhada de um job do cliente: X e Y são preenchidos direto nos buffers
+// enviados ao servidor e Z é o mapeamento do buffer da resposta
+typedef struct
+{
+    int descriptors[2];
+
+    void *mappings[3];
+    size_t sizes[3];
+} ClientBuffers;
+
+typedef struct
+{
+    int listening;
+    int connections[SRV_MAX_CONNECTIONS];
+    int connectionCount;
+
+    // Fila de prioridades (heap binário) dos pedidos ainda não iniciados
+    ServerJob *queue[SRV_MAX_QUEUE];
+    int queueCount;
+    unsigned long long sequence;
+
+    ServerJob *running;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::thread thread;
+} Server;
+
+// Cria um buffer de memória compartilhada com tal tamanho e o mapeia em data
+// Retorna o descritor do buffer (-1 em caso de erro)
+int CreateSharedBuffer(size_t size, void **data)
+{
+    int descriptor = memfd_create("matrix", MFD_CLOEXEC);
+
+    if (descriptor == -1)
+        return -1;
+
+    // Um buffer vazio ainda precisa de um byte para ser mapeado
+    size_t length = size > 0 ? size : 1;
+
+    if (ftruncate(descriptor, (off_t)length) != 0)
+    {
+        close(descriptor);
+        return -1;
+    }
+
+    *data = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+
+    if (*data == MAP_FAILED)
+    {
+        close(descriptor);
+        return -1;
+    }
+
+    return descriptor;
+}
+
+// Mapeia um buffer recebido, verificando que ele tenha pelo menos tal tamanho
+// O mapeamento é privado: as operações que escrevem nas entradas não alteram o buffer do cliente
+void *MapSharedBuffer(int descriptor, size_t size)
+{
+    struct stat status;
+
+    size_t length = size > 0 ? size : 1;
+
+    if (fstat(descriptor, &status) != 0 || (size_t)status.st_size < length)
+        return NULL;
+
+    void *data = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+
+    return data != MAP_FAILED ? data : NULL;
+}
+
+// Desfaz o mapeamento de um buffer de tal tamanho
+void UnmapSharedBuffer(void *data, size_t size)
+{
+    if (data != NULL)
+        munmap(data, size > 0 ? size : 1);
+}
+
+// Envia uma mensagem acompanhada de descritores
+bool SendServerMessage(int socket, const void *message, size_t size, const int *descriptors, int count)
+{
+    struct iovec vector;
+    vector.iov_base = (void *)message;
+    vector.iov_len = size;
+
+    char control[CMSG_SPACE(2 * sizeof(int))];
+    memset(control, 0, sizeof(control));
+
+    struct msghdr header;
+    memset(&header, 0, sizeof(header));
+
+    header.msg_iov = &vector;
+    header.msg_iovlen = 1;
+
+    if (count > 0)
+    {
+        header.msg_control = control;
+        header.msg_controllen = CMSG_SPACE(count * sizeof(int));
+
+        struct cmsghdr *descriptorMessage = CMSG_FIRSTHDR(&header);
+        descriptorMessage->cmsg_level = SOL_SOCKET;
+        descriptorMessage->cmsg_type = SCM_RIGHTS;
+        descriptorMessage->cmsg_len = CMSG_LEN(count * sizeof(int));
+
+        memcpy(CMSG_DATA(descriptorMessage), descriptors, count * sizeof(int));
+    }
+
+    return sendmsg(socket, &header, MSG_NOSIGNAL) == (ssize_t)size;
+}
+
+// Recebe uma mensagem de exatamente tal tamanho e até 2 descritores
+// Retorna falso caso a conexão tenha sido fechada ou a mensagem seja inválida
+// (os descritores recebidos são fechados nesse caso)
+bool ReceiveServerMessage(int socket, void *message, size_t size, int *descriptors, int *count)
+{
+    struct iovec vector;
+    vector.iov_base = message;
+    vector.iov_len = size;
+
+    char control[CMSG_SPACE(2 * sizeof(int))];
+
+    struct msghdr header;
+    memset(&header, 0, sizeof(header));
+
+    header.msg_iov = &vector;
+    header.msg_iovlen = 1;
+    header.msg_control = control;
+    header.msg_controllen = sizeof(control);
+
+    ssize_t received = recvmsg(socket, &header, MSG_CMSG_CLOEXEC);
+
+    *count = 0;
+
+    // Sem mensagem, a área de controle não foi preenchida
+    if (received <= 0)
+        header.msg_controllen = 0;
+
+    for (struct cmsghdr *descriptorMessage = CMSG_FIRSTHDR(&header); descriptorMessage != NULL; descriptorMessage = CMSG_NXTHDR(&header, descriptorMessage))
+    {
+        if (descriptorMessage->cmsg_level != SOL_SOCKET || descriptorMessage->cmsg_type != SCM_RIGHTS)
+            continue;
+
+        int available = (int)((descriptorMessage->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+        const unsigned char *data = CMSG_DATA(descriptorMessage);
+
+        for (int k = 0; k < available; k++)
+        {
+            int descriptor;
+            memcpy(&descriptor, data + k * sizeof(int), sizeof(int));
+
+            if (*count < 2)
+                descriptors[(*count)++] = descriptor;
+            else
+                close(descriptor);
+        }
+    }
+
+    if (received != (ssize_t)size || (header.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0)
+    {
+        for (int k = 0; k < *count; k++)
+            close(descriptors[k]);
+
+        *count = 0;
+        return false;
+    }
+
+    return true;
+}
+
+// Verifica se o pedido a deve ser executado antes do pedido b
+bool ServerJobPrecedes(const ServerJob *a, const ServerJob *b)
+{
+    return a->priority > b->priority || (a->priority == b->priority && a->sequence < b->sequence);
+}
+
+// Coloca o pedido na fila de prioridades (com a trava do servidor)
+// Retorna falso caso a fila esteja cheia
+bool PushServerJob(Server *server, ServerJob *work)
+{
+    if (server->queueCount == SRV_MAX_QUEUE)
+        return false;
+
+    work->sequence = server->sequence++;
+
+    int k = server->queueCount++;
+
+    while (k > 0 && ServerJobPrecedes(work, server->queue[(k - 1) / 2]))
+    {
+        server->queue[k] = server->queue[(k - 1) / 2];
+        k = (k - 1) / 2;
+    }
+
+    server->queue[k] = work;
+
+    return true;
+}
+
+// Retira da fila o pedido na posição k (com a trava do servidor)
+ServerJob *RemoveServerJob(Server *server, int k)
+{
+    ServerJob *work = server->queue[k];
+    ServerJob *last = server->queue[--server->queueCount];
+
+    if (k == server->queueCount)
+        return work;
+
+    // O último pedido ocupa a posição k e sobe ou desce até o seu lugar
+    while (k > 0 && ServerJobPrecedes(last, server->queue[(k - 1) / 2]))
+    {
+        server->queue[k] = server->queue[(k - 1) / 2];
+        k = (k - 1) / 2;
+    }
+
+    while (true)
+    {
+        int child = 2 * k + 1;
+
+        if (child >= server->queueCount)
+            break;
+
+        if (child + 1 < server->queueCount && ServerJobPrecedes(server->queue[child + 1], server->queue[child]))
+            child++;
+
+        if (!ServerJobPrecedes(server->queue[child], last))
+            break;
+
+        server->queue[k] = server->queue[child];
+        k = child;
+    }
+
+    server->queue[k] = last;
+
+    return work;
+}
+
+// Libera o pedido, suas entradas mapeadas e a sua cópia da conexão
+void ReleaseServerJob(ServerJob *work)
+{
+    Job *job = work->job;
+
+    // As entradas são mapeamentos (a transposta pode ter usado X como resultado)
+    if (job->z == work->mappings[0])
+        job->z = NULL;
+
+    job->x = NULL;
+    job->y = NULL;
+
+    FreeJob(job);
+
+    UnmapSharedBuffer(work->mappings[0], work->sizes[0]);
+    UnmapSharedBuffer(work->mappings[1], work->sizes[1]);
+
+    close(work->reply);
+    free(work);
+}
+
+// Responde um pedido concluído, com o resultado em um novo buffer compartilhado
+void ReplyServerJob(ServerJob *work)
+{
+    Job *job = work->job;
+
+    ServerResponse response;
+    memset(&response, 0, sizeof(response));
+
+    response.magic = SRV_MAGIC;
+    response.success = job->success;
+    response.rowsZ = job->success ? job->rowsZ : 0;
+    response.columnsZ = job->success ? job->columnsZ : 0;
+    response.precisionError = job->precisionError;
+    strcpy(response.error, job->error);
+
+    response.verified = job->verified;
+    response.verificationError = job->verificationError;
+
+    response.solveHistory = job->solveHistory;
+    strcpy(response.solveMethod, job->solveMethod);
+
+    if (!job->success)
+    {
+        SendServerMessage(work->reply, &response, sizeof(response), NULL, 0);
+        return;
+    }
+
+    size_t size = (size_t)job->rowsZ * job->columnsZ * sizeof(double);
+
+    void *data;
+    int descriptor = CreateSharedBuffer(size, &data);
+
+    if (descriptor == -1)
+    {
+        response.success = false;
+        strcpy(response.error, "sem memoria compartilhada");
+
+        SendServerMessage(work->reply, &response, sizeof(response), NULL, 0);
+        return;
+    }
+
+    memcpy(data, job->z, size);
+    UnmapSharedBuffer(data, size);
+
+    SendServerMessage(work->reply, &response, sizeof(response), &descriptor, 1);
+    close(descriptor);
+}
+
+// Laço da thread de cálculo: executa os pedidos por ordem de prioridade
+void RunServerJobs(Server *server)
+{
+    std::unique_lock<std::mutex> lock(server->mutex);
+
+    while (true)
+    {
+        server->condition.wait(lock, [server]() { return server->queueCount > 0; });
+
+        ServerJob *work = RemoveServerJob(server, 0);
+        server->running = work;
+
+        lock.unlock();
+
+        ExecuteJob(work->job, &work->task);
+
+        if (!IsTaskCancelled(&work->task))
+            ReplyServerJob(work);
+
+        // O pedido deixa de ser visível para CancelConnectionJobs antes de ser liberado
+        lock.lock();
+        server->running = NULL;
+        lock.unlock();
+
+        ReleaseServerJob(work);
+
+        lock.lock();
+    }
+}
+
+// Cancela os pedidos feitos por uma conexão que foi fechada
+void CancelConnectionJobs(Server *server, int connection)
+{
+    struct stat closed;
+    fstat(connection, &closed);
+
+    std::lock_guard<std::mutex> lock(server->mutex);
+
+    // As respostas usam cópias do descritor, comparadas pelo socket a que se referem
+    for (int k = server->queueCount - 1; k >= 0; k--)
+    {
+        struct stat status;
+
+        if (fstat(server->queue[k]->reply, &status) == 0 && status.st_ino == closed.st_ino)
+            ReleaseServerJob(RemoveServerJob(server, k));
+    }
+
+    struct stat status;
+
+    if (server->running != NULL && fstat(server->running->reply, &status) == 0 && status.st_ino == closed.st_ino)
+        CancelTask(&server->running->task);
+}
+
+// Recebe um pedido da conexão e o coloca na fila
+// Retorna falso caso a conexão tenha sido fechada
+bool ReceiveServerJob(Server *server, int connection)
+{
+    ServerRequest request;
+    int descriptors[2];
+    int count;
+
+    if (!ReceiveServerMessage(connection, &request, sizeof(request), descriptors, &count))
+        return false;
+
+    ServerResponse response;
+    memset(&response, 0, sizeof(response));
+    response.magic = SRV_MAGIC;
+
+    bool valid = request.magic == SRV_MAGIC && count == 2 &&
+                 request.operation >= 0 && request.operation < OPERATION_NUM &&
+                 request.precision >= 0 && request.precision < PRECISION_NUM &&
+                 request.rowsX >= 0 && request.columnsX >= 0 &&
+                 request.rowsY >= 0 && request.columnsY >= 0;
+
+    ServerJob *work = (ServerJob *)malloc(sizeof(ServerJob));
+
+    work->sizes[0] = (size_t)request.rowsX * request.columnsX * sizeof(double);
+    work->sizes[1] = (size_t)request.rowsY * request.columnsY * sizeof(double);
+    work->mappings[0] = valid ? MapSharedBuffer(descriptors[0], work->sizes[0]) : NULL;
+    work->mappings[1] = valid ? MapSharedBuffer(descriptors[1], work->sizes[1]) : NULL;
+
+    // O mapeamento continua válido depois que os descritores são fechados
+    for (int k = 0; k < count; k++)
+        close(descriptors[k]);
+
+    if (work->mappings[0] == NULL || work->mappings[1] == NULL)
+    {
+        UnmapSharedBuffer(work->mappings[0], work->sizes[0]);
+        UnmapSharedBuffer(work->mappings[1], work->sizes[1]);
+        free(work);
+
+        strcpy(response.error, "pedido invalido");
+        SendServerMessage(connection, &response, sizeof(response), NULL, 0);
+
+        return true;
+    }
+
+    Job *job = CreateJob(request.operation, 0, 0, 0, 0);
+
+    free(job->x);
+    free(job->y);
+
+    job->precision = request.precision;
+    job->iterative = request.iterative != 0;
+    job->verify = request.verify != 0;
+    job->exponent = request.exponent;
+
+    job->rowsX = request.rowsX;
+    job->columnsX = request.columnsX;
+    job->rowsY = request.rowsY;
+    job->columnsY = request.columnsY;
+
+    job->x = (double *)work->mappings[0];
+    job->y = (double *)work->mappings[1];
+
+    DetectStructure(job->x, job->rowsX, job->columnsX, &job->structureX);
+    DetectStructure(job->y, job->rowsY, job->columnsY, &job->structureY);
+
+    work->job = job;
+    work->priority = request.priority;
+    work->reply = dup(connection);
+
+    InitializeTask(&work->task);
+
+    std::lock_guard<std::mutex> lock(server->mutex);
+
+    if (work->reply == -1 || !PushServerJob(server, work))
+    {
+        if (work->reply != -1)
+        {
+            strcpy(response.error, "fila cheia");
+            SendServerMessage(connection, &response, sizeof(response), NULL, 0);
+        }
+
+        ReleaseServerJob(work);
+        return true;
+    }
+
+    server->condition.notify_one();
+
+    return true;
+}
+
+// Executa o servidor no caminho do socket até um erro fatal
+// Retorna falso caso o socket não possa ser criado
+bool RunServer(Server *server, const char *path)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+
+    address.sun_family = AF_UNIX;
+
+    if (strlen(path) >= sizeof(address.sun_path))
+        return false;
+
+    strcpy(address.sun_path, path);
+
+    // Um socket deixado por uma execução anterior impediria o bind
+    unlink(path);
+
+    server->listening = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+
+    if (server->listening == -1 ||
+        bind(server->listening, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+        listen(server->listening, SRV_MAX_CONNECTIONS) != 0)
+    {
+        perror("servidor");
+        return false;
+    }
+
+    server->connectionCount = 0;
+    server->queueCount = 0;
+    server->sequence = 0;
+    server->running = NULL;
+
+    server->thread = std::thread(RunServerJobs, server);
+    server->thread.detach();
+
+    printf("servidor aguardando em %s\n", path);
+    fflush(stdout);
+
+    struct pollfd descriptors[SRV_MAX_CONNECTIONS + 1];
+
+    while (true)
+    {
+        descriptors[0].fd = server->listening;
+        descriptors[0].events = POLLIN;
+
+        for (int k = 0; k < server->connectionCount; k++)
+        {
+            descriptors[k + 1].fd = server->connections[k];
+            descriptors[k + 1].events = POLLIN;
+        }
+
+        if (poll(descriptors, server->connectionCount + 1, -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            perror("servidor");
+            return true;
+        }
+
+        // As conexões são percorridas de trás para frente para que a remoção não pule nenhuma
+        for (int k = server->connectionCount - 1; k >= 0; k--)
+        {
+            if (descriptors[k + 1].revents == 0)
+                continue;
+
+            int connection = server->connections[k];
+
+            if ((descriptors[k + 1].revents & POLLIN) != 0 && ReceiveServerJob(server, connection))
+                continue;
+
+            CancelConnectionJobs(server, connection);
+            close(connection);
+
+            server->connections[k] = server->connections[--server->connectionCount];
+        }
+
+        if ((descriptors[0].revents & POLLIN) != 0)
+        {
+            int connection = accept4(server->listening, NULL, NULL, SOCK_CLOEXEC);
+
+            if (connection != -1 && server->connectionCount == SRV_MAX_CONNECTIONS)
+                close(connection);
+            else if (connection != -1)
+                server->connections[server->connectionCount++] = connection;
+        }
+    }
+}
+
+// Cria um job como o CreateJob, mas com X e Y em memória compartilhada, para que
+// o ExecuteServerJob envie ao servidor as próprias matrizes do job
+// Retorna NULL caso a memória compartilhada não possa ser criada
+Job *CreateClientJob(int operation, int rowsX, int columnsX, int rowsY, int columnsY)
+{
+    ClientBuffers *buffers = (ClientBuffers *)malloc(sizeof(ClientBuffers));
+
+    buffers->sizes[0] = (size_t)rowsX * columnsX * sizeof(double);
+    buffers->sizes[1] = (size_t)rowsY * columnsY * sizeof(double);
+    buffers->sizes[2] = 0;
+    buffers->mappings[2] = NULL;
+
+    for (int k = 0; k < 2; k++)
+    {
+        buffers->descriptors[k] = CreateSharedBuffer(buffers->sizes[k], &buffers->mappings[k]);
+
+        if (buffers->descriptors[k] == -1)
+        {
+            for (int created = 0; created < k; created++)
+            {
+                UnmapSharedBuffer(buffers->mappings[created], buffers->sizes[created]);
+                close(buffers->descriptors[created]);
+            }
+
+            free(buffers);
+            return NULL;
+        }
+    }
+
+    Job *job = CreateJob(operation, 0, 0, 0, 0);
+
+    free(job->x);
+    free(job->y);
+
+    job->rowsX = rowsX;
+    job->columnsX = columnsX;
+    job->rowsY = rowsY;
+    job->columnsY = columnsY;
+
+    job->x = (double *)buffers->mappings[0];
+    job->y = (double *)buffers->mappings[1];
+
+    job->shared = buffers;
+
+    return job;
+}
+
+// Libera um job criado pelo CreateClientJob (ou pelo CreateJob), desfazendo os mapeamentos
+void FreeClientJob(void *work)
+{
+    Job *job = (Job *)work;
+    ClientBuffers *buffers = (ClientBuffers *)job->shared;
+
+    if (buffers != NULL)
+    {
+        // Um cálculo local pode ter movido uma entrada para o resultado (como a transposta)
+        for (int k = 0; k < 3; k++)
+        {
+            if (buffers->mappings[k] == NULL)
+                continue;
+
+            if (job->x == buffers->mappings[k])
+                job->x = NULL;
+
+            if (job->y == buffers->mappings[k])
+                job->y = NULL;
+
+            if (job->z == buffers->mappings[k])
+                job->z = NULL;
+
+            UnmapSharedBuffer(buffers->mappings[k], buffers->sizes[k]);
+        }
+
+        close(buffers->descriptors[0]);
+        close(buffers->descriptors[1]);
+
+        free(buffers);
+    }
+
+    FreeJob(job);
+}
+
+// Calcula no servidor um job criado pelo CreateClientJob, como faria o ExecuteJob
+// O servidor é abandonado (e cancela o cálculo) caso a tarefa seja cancelada
+void ExecuteServerJob(const char *path, Job *job, int priority, Task *task)
+{
+    ClientBuffers *buffers = (ClientBuffers *)job->shared;
+
+    if (buffers == NULL)
+    {
+        FailJob(job, "matrizes fora da memoria compartilhada");
+        return;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s", path);
+
+    int connection = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+
+    if (connection == -1 || connect(connection, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        if (connection != -1)
+            close(connection);
+
+        FailJob(job, "servidor indisponivel");
+        return;
+    }
+
+    ServerRequest request;
+    memset(&request, 0, sizeof(request));
+
+    request.magic = SRV_MAGIC;
+    request.priority = priority;
+    request.operation = job->operation;
+    request.precision = job->precision;
+    request.iterative = job->iterative;
+    request.verify = job->verify;
+    request.exponent = job->exponent;
+    request.rowsX = job->rowsX;
+    request.columnsX = job->columnsX;
+    request.rowsY = job->rowsY;
+    request.columnsY = job->columnsY;
+
+    // X e Y já estão nos buffers compartilhados, que continuam mapeados até o job ser liberado
+    if (!SendServerMessage(connection, &request, sizeof(request), buffers->descriptors, 2))
+    {
+        close(connection);
+        FailJob(job, "falha ao enviar ao servidor");
+        return;
+    }
+
+    struct pollfd waiting;
+    waiting.fd = connection;
+    waiting.events = POLLIN;
+
+    while (poll(&waiting, 1, SRV_POLL_INTERVAL) <= 0 || (waiting.revents & (POLLIN | POLLHUP | POLLERR)) == 0)
+    {
+        if (IsTaskCancelled(task))
+        {
+            close(connection);
+            return;
+        }
+    }
+
+    ServerResponse response;
+    int received[2], count;
+
+    bool valid = ReceiveServerMessage(connection, &response, sizeof(response), received, &count) &&
+                 response.magic == SRV_MAGIC &&
+                 count == (response.success ? 1 : 0);
+
+    close(connection);
+
+    if (!valid)
+    {
+        for (int k = 0; k < count; k++)
+            close(received[k]);
+
+        FailJob(job, "resposta invalida do servidor");
+        return;
+    }
+
+    if (!response.success)
+    {
+        response.error[sizeof(response.error) - 1] = '\0';
+        FailJob(job, response.error);
+        return;
+    }
+
+    size_t size = (size_t)response.rowsZ * response.columnsZ * sizeof(double);
+    void *data = response.rowsZ >= 0 && response.columnsZ >= 0 ? MapSharedBuffer(received[0], size) : NULL;
+
+    close(received[0]);
+
+    if (data == NULL)
+    {
+        FailJob(job, "resposta invalida do servidor");
+        return;
+    }
+
+    // Z é lido no próprio buffer da resposta, mapeado até o job ser liberado
+    buffers->mappings[2] = data;
+    buffers->sizes[2] = size;
+
+    job->rowsZ = response.rowsZ;
+    job->columnsZ = response.columnsZ;
+    job->z = (double *)data;
+
+    job->precisionError = response.precisionError;
+    job->verified = response.verified != 0;
+    job->verificationError = response.verificationError;
+    job->solveHistory = response.solveHistory;
+
+    memcpy(job->solveMethod, response.solveMethod, sizeof(job->solveMethod));
+    job->solveMethod[sizeof(job->solveMethod) - 1] = '\0';
+
+    job->success = true;
+}
+
+#endif
+
+#endif
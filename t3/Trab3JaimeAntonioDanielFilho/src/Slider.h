@@ -0,0 +1,95 @@
+/*********************************************************************
+// Slider.h
+// Implementação de uma barra deslizante horizontal, cujo valor vai de 0
+// até 1 e é alterado ao clicar ou arrastar o marcador sobre ela.
+// *********************************************************************/
+
+#ifndef SLIDER_H
+#define SLIDER_H
+
+#define SLD_HEIGHT 12
+#define SLD_THUMB_WIDTH 8
+
+typedef struct
+{
+    float x, y;
+    float width;
+
+    float value;
+
+    bool hovering;
+    bool dragging;
+} Slider;
+
+// Inicializa a barra com tal largura e valor
+void InitializeSlider(Slider *slider, float width, float value)
+{
+    slider->width = width;
+    slider->value = value;
+
+    slider->hovering = false;
+    slider->dragging = false;
+}
+
+// Verifica se a coordenada está dentro da barra
+bool IsInsideSlider(Slider *slider, int x, int y)
+{
+    float distanceX = x - slider->x;
+    float distanceY = y - slider->y;
+
+    return distanceX >= 0 && distanceX <= slider->width &&
+           distanceY >= 0 && distanceY <= SLD_HEIGHT;
+}
+
+// Desenha a barra
+void DrawSlider(Slider *slider)
+{
+    float x1 = slider->x;
+    float y1 = slider->y;
+
+    float x2 = x1 + slider->width;
+    float y2 = y1 + SLD_HEIGHT;
+
+    Color8(200, 200, 200);
+    CV::line(x1, (y1 + y2) / 2, x2, (y1 + y2) / 2);
+
+    float thumb = x1 + slider->value * (slider->width - SLD_THUMB_WIDTH);
+
+    if (slider->hovering || slider->dragging)
+    {
+        Color8(255, 199, 128);
+        CV::rectFill(thumb, y1, thumb + SLD_THUMB_WIDTH, y2);
+    }
+
+    Color8(255, 145, 3);
+    CV::rect(thumb, y1, thumb + SLD_THUMB_WIDTH, y2);
+}
+
+// Processa o mouse para a barra
+// Retorna verdadeiro caso o valor tenha sido alterado
+bool ProccessSliderMouse(Slider *slider, int mouseX, int mouseY, int mouseButton, int mouseState)
+{
+    slider->hovering = IsInsideSlider(slider, mouseX, mouseY);
+
+    if (mouseButton == 0 && mouseState == 0 && slider->hovering)
+        slider->dragging = true;
+
+    if (mouseButton == 0 && mouseState == 1)
+        slider->dragging = false;
+
+    if (!slider->dragging)
+        return false;
+
+    float value = (mouseX - slider->x - SLD_THUMB_WIDTH / 2.0f) / (slider->width - SLD_THUMB_WIDTH);
+
+    value = value < 0 ? 0 : value > 1 ? 1 : value;
+
+    if (value == slider->value)
+        return false;
+
+    slider->value = value;
+
+    return true;
+}
+
+#endif
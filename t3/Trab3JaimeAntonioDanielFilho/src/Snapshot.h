@@ -0,0 +1,352 @@
+/*********************************************************************
+// Snapshot.h
+// Arquivo de sessão com o estado completo da área de trabalho. O arquivo
+// começa com um cabeçalho versionado e uma tabela de seções, cada uma
+// identificada por um tipo e uma chave e localizada pelo deslocamento a
+// partir do início do arquivo (sem ponteiros), então ele pode ser mapeado
+// em qualquer endereço. Os dados das seções ficam alinhados e são lidos
+// diretamente do mapeamento, sem cópia nem interpretação de texto. Seções
+// de tipos desconhecidos são ignoradas; mudanças incompatíveis no formato
+// de uma seção exigem uma nova versão.
+// *********************************************************************/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SNP_MAGIC "MTXSNAP"
+#define SNP_VERSION 2
+
+// Valor gravado no cabeçalho para recusar arquivos de outra ordem de bytes
+#define SNP_BYTE_ORDER 0x01020304u
+
+#define SNP_MAX_SECTIONS 32
+
+// Alinhamento do início dos dados de cada seção
+#define SNP_ALIGNMENT 64
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+
+    // Tamanho total do arquivo, para recusar arquivos truncados
+    uint64_t size;
+
+    uint32_t sectionCount;
+    uint32_t reserved;
+} SnapshotHeader;
+
+typedef struct
+{
+    uint32_t type;
+    uint32_t key;
+
+    // Deslocamento a partir do início do arquivo
+    uint64_t offset;
+    uint64_t size;
+} SnapshotSection;
+
+// Arquivo de sessão sendo gravado
+typedef struct
+{
+    FILE *file;
+    char path[260];
+
+    SnapshotSection sections[SNP_MAX_SECTIONS];
+    uint32_t count;
+
+    uint64_t offset;
+    bool failed;
+} SnapshotWriter;
+
+// Arquivo de sessão mapeado na memória, somente para leitura
+typedef struct
+{
+    const unsigned char *data;
+    size_t size;
+
+    const SnapshotHeader *header;
+    const SnapshotSection *sections;
+
+#ifdef _WIN32
+    HANDLE file, mapping;
+#endif
+} Snapshot;
+
+// Grava zeros no arquivo até o deslocamento, que deve estar adiante da posição atual
+bool PadSnapshotFile(SnapshotWriter *writer, uint64_t offset)
+{
+    static const char zeros[SNP_ALIGNMENT] = {0};
+
+    while (writer->offset < offset)
+    {
+        size_t count = offset - writer->offset < SNP_ALIGNMENT ? (size_t)(offset - writer->offset) : SNP_ALIGNMENT;
+
+        if (fwrite(zeros, 1, count, writer->file) != count)
+            return false;
+
+        writer->offset += count;
+    }
+
+    return true;
+}
+
+// Deslocamento do primeiro byte após o cabeçalho e a tabela de seções
+uint64_t SnapshotDataStart()
+{
+    uint64_t start = sizeof(SnapshotHeader) + SNP_MAX_SECTIONS * sizeof(SnapshotSection);
+
+    return (start + SNP_ALIGNMENT - 1) / SNP_ALIGNMENT * SNP_ALIGNMENT;
+}
+
+// Começa a gravação de um arquivo de sessão
+// Os dados vão para um arquivo temporário, que só substitui o anterior em EndSnapshotFile
+bool BeginSnapshotFile(SnapshotWriter *writer, const char *path)
+{
+    snprintf(writer->path, sizeof(writer->path), "%s", path);
+
+    char temporary[270];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+
+    writer->file = fopen(temporary, "wb");
+    writer->count = 0;
+    writer->offset = 0;
+
+    // O cabeçalho e a tabela são gravados por último, sobre este espaço
+    writer->failed = writer->file == NULL || !PadSnapshotFile(writer, SnapshotDataStart());
+
+    return !writer->failed;
+}
+
+// Grava uma seção com tais dados, alinhada a SNP_ALIGNMENT
+void WriteSnapshotSection(SnapshotWriter *writer, uint32_t type, uint32_t key, const void *data, size_t size)
+{
+    if (writer->failed)
+        return;
+
+    if (writer->count == SNP_MAX_SECTIONS)
+    {
+        writer->failed = true;
+        return;
+    }
+
+    SnapshotSection *section = &writer->sections[writer->count++];
+
+    section->type = type;
+    section->key = key;
+    section->offset = writer->offset;
+    section->size = size;
+
+    uint64_t end = (writer->offset + size + SNP_ALIGNMENT - 1) / SNP_ALIGNMENT * SNP_ALIGNMENT;
+
+    if (fwrite(data, 1, size, writer->file) != size)
+    {
+        writer->failed = true;
+        return;
+    }
+
+    writer->offset += size;
+    writer->failed = !PadSnapshotFile(writer, end);
+}
+
+// Grava o cabeçalho e a tabela de seções e substitui o arquivo anterior
+// Retorna falso caso alguma gravação tenha falhado (o arquivo anterior é mantido)
+bool EndSnapshotFile(SnapshotWriter *writer)
+{
+    char temporary[270];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", writer->path);
+
+    if (writer->file == NULL)
+        return false;
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+
+    strcpy(header.magic, SNP_MAGIC);
+    header.version = SNP_VERSION;
+    header.byteOrder = SNP_BYTE_ORDER;
+    header.size = writer->offset;
+    header.sectionCount = writer->count;
+
+    SnapshotSection sections[SNP_MAX_SECTIONS];
+    memset(sections, 0, sizeof(sections));
+    memcpy(sections, writer->sections, writer->count * sizeof(SnapshotSection));
+
+    if (writer->failed ||
+        fseek(writer->file, 0, SEEK_SET) != 0 ||
+        fwrite(&header, sizeof(header), 1, writer->file) != 1 ||
+        fwrite(sections, sizeof(sections), 1, writer->file) != 1)
+    {
+        writer->failed = true;
+    }
+
+    if (fclose(writer->file) != 0)
+        writer->failed = true;
+
+    writer->file = NULL;
+
+    if (writer->failed)
+    {
+        remove(temporary);
+        return false;
+    }
+
+#ifdef _WIN32
+    return MoveFileExA(temporary, writer->path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(temporary, writer->path) == 0;
+#endif
+}
+
+// Desfaz o mapeamento do arquivo de sessão
+void CloseSnapshot(Snapshot *snapshot)
+{
+#ifdef _WIN32
+    if (snapshot->data != NULL)
+        UnmapViewOfFile(snapshot->data);
+
+    if (snapshot->mapping != NULL)
+        CloseHandle(snapshot->mapping);
+
+    if (snapshot->file != INVALID_HANDLE_VALUE)
+        CloseHandle(snapshot->file);
+
+    snapshot->mapping = NULL;
+    snapshot->file = INVALID_HANDLE_VALUE;
+#else
+    if (snapshot->data != NULL)
+        munmap((void *)snapshot->data, snapshot->size);
+#endif
+
+    snapshot->data = NULL;
+    snapshot->size = 0;
+}
+
+// Mapeia o arquivo de sessão na memória e valida o cabeçalho e a tabela de seções
+// Retorna falso caso o arquivo não exista ou não seja uma sessão válida desta versão
+bool OpenSnapshot(Snapshot *snapshot, const char *path)
+{
+    snapshot->data = NULL;
+    snapshot->size = 0;
+
+#ifdef _WIN32
+    snapshot->mapping = NULL;
+    snapshot->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (snapshot->file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(snapshot->file, &size) || size.QuadPart < (LONGLONG)SnapshotDataStart())
+    {
+        CloseSnapshot(snapshot);
+        return false;
+    }
+
+    snapshot->mapping = CreateFileMappingA(snapshot->file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (snapshot->mapping != NULL)
+        snapshot->data = (const unsigned char *)MapViewOfFile(snapshot->mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (snapshot->data == NULL)
+    {
+        CloseSnapshot(snapshot);
+        return false;
+    }
+
+    snapshot->size = (size_t)size.QuadPart;
+#else
+    int descriptor = open(path, O_RDONLY);
+
+    if (descriptor == -1)
+        return false;
+
+    struct stat status;
+
+    if (fstat(descriptor, &status) != 0 || status.st_size < (off_t)SnapshotDataStart())
+    {
+        close(descriptor);
+        return false;
+    }
+
+    void *data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    // O mapeamento continua válido depois que o descritor é fechado
+    close(descriptor);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    snapshot->data = (const unsigned char *)data;
+    snapshot->size = (size_t)status.st_size;
+#endif
+
+    snapshot->header = (const SnapshotHeader *)snapshot->data;
+    snapshot->sections = (const SnapshotSection *)(snapshot->data + sizeof(SnapshotHeader));
+
+    const SnapshotHeader *header = snapshot->header;
+
+    bool valid = memcmp(header->magic, SNP_MAGIC, sizeof(SNP_MAGIC)) == 0 &&
+                 header->version == SNP_VERSION &&
+                 header->byteOrder == SNP_BYTE_ORDER &&
+                 header->size == snapshot->size &&
+                 header->sectionCount <= SNP_MAX_SECTIONS;
+
+    for (uint32_t k = 0; valid && k < header->sectionCount; k++)
+    {
+        const SnapshotSection *section = &snapshot->sections[k];
+
+        valid = section->offset % SNP_ALIGNMENT == 0 &&
+                section->offset <= snapshot->size &&
+                section->size <= snapshot->size - section->offset;
+    }
+
+    if (!valid)
+    {
+        CloseSnapshot(snapshot);
+        return false;
+    }
+
+    return true;
+}
+
+// Retorna os dados da seção de tal tipo e chave (NULL caso não exista)
+// Seções com tamanho fixo podem exigir o tamanho exato com expected (0 aceita qualquer um)
+const void *FindSnapshotSection(const Snapshot *snapshot, uint32_t type, uint32_t key, size_t expected, size_t *size = NULL)
+{
+    for (uint32_t k = 0; k < snapshot->header->sectionCount; k++)
+    {
+        const SnapshotSection *section = &snapshot->sections[k];
+
+        if (section->type != type || section->key != key)
+            continue;
+
+        if (expected != 0 && section->size != expected)
+            return NULL;
+
+        if (size != NULL)
+            *size = (size_t)section->size;
+
+        return snapshot->data + section->offset;
+    }
+
+    return NULL;
+}
+
+#endif
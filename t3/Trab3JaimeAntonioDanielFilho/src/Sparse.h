@@ -0,0 +1,124 @@
+/*********************************************************************
+// Sparse.h
+// Matrizes esparsas no formato CSR (linhas comprimidas): para cada linha
+// são armazenados apenas os elementos não nulos, ordenados pela coluna.
+// O produto matriz-vetor é dividido entre várias threads para matrizes
+// com muitas linhas.
+// *********************************************************************/
+
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Parallel.h"
+
+// Quantidade mínima de linhas processadas por thread no produto matriz-vetor
+#define SPR_PARALLEL_GRAIN 4096
+
+typedef struct
+{
+    int rows, columns;
+    int nonzeros;
+
+    int *offsets; // início de cada linha em indices e values (rows + 1)
+    int *indices; // coluna de cada elemento
+    double *values;
+} SparseMatrix;
+
+// Aloca uma matriz esparsa com espaço para tal quantidade de elementos
+void InitializeSparse(SparseMatrix *matrix, int rows, int columns, int nonzeros)
+{
+    matrix->rows = rows;
+    matrix->columns = columns;
+    matrix->nonzeros = nonzeros;
+
+    matrix->offsets = (int *)calloc(rows + 1, sizeof(int));
+    matrix->indices = (int *)malloc(nonzeros * sizeof(int));
+    matrix->values = (double *)malloc(nonzeros * sizeof(double));
+}
+
+// Libera a memória ocupada pela matriz esparsa
+void FreeSparse(SparseMatrix *matrix)
+{
+    free(matrix->offsets);
+    free(matrix->indices);
+    free(matrix->values);
+
+    matrix->offsets = NULL;
+    matrix->indices = NULL;
+    matrix->values = NULL;
+}
+
+// Converte um array denso (rows x columns) para o formato CSR
+void DenseToSparse(const double *a, int rows, int columns, SparseMatrix *matrix)
+{
+    int nonzeros = 0;
+
+    for (size_t k = 0; k < (size_t)rows * columns; k++)
+        nonzeros += a[k] != 0;
+
+    InitializeSparse(matrix, rows, columns, nonzeros);
+
+    int position = 0;
+
+    for (int i = 0; i < rows; i++)
+    {
+        matrix->offsets[i] = position;
+
+        for (int j = 0; j < columns; j++)
+        {
+            if (a[(size_t)i * columns + j] != 0)
+            {
+                matrix->indices[position] = j;
+                matrix->values[position] = a[(size_t)i * columns + j];
+
+                position++;
+            }
+        }
+    }
+
+    matrix->offsets[rows] = position;
+}
+
+// Multiplica a matriz esparsa pelo vetor x, escrevendo o resultado em y
+void SparseMultiplyVector(const SparseMatrix *matrix, const double *x, double *y)
+{
+    ParallelFor(0, matrix->rows, SPR_PARALLEL_GRAIN, [=](int first, int last)
+    {
+        for (int i = first; i < last; i++)
+        {
+            double sum = 0;
+
+            for (int k = matrix->offsets[i]; k < matrix->offsets[i + 1]; k++)
+                sum += matrix->values[k] * x[matrix->indices[k]];
+
+            y[i] = sum;
+        }
+    });
+}
+
+// Retorna a posição do elemento (i, j) em values ou -1 caso ele seja nulo
+int SparseFind(const SparseMatrix *matrix, int i, int j)
+{
+    int low = matrix->offsets[i];
+    int high = matrix->offsets[i + 1] - 1;
+
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+
+        if (matrix->indices[middle] == j)
+            return middle;
+
+        if (matrix->indices[middle] < j)
+            low = middle + 1;
+        else
+            high = middle - 1;
+    }
+
+    return -1;
+}
+
+#endif
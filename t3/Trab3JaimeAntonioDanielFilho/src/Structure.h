@@ -0,0 +1,449 @@
+/*********************************************************************
+// Structure.h
+// Detecção da estrutura de uma matriz (diagonal, triangular, em banda,
+// simétrica e simétrica definida positiva) e versões especializadas do
+// determinante, da multiplicação e da resolução de sistemas que tiram
+// proveito dessa estrutura.
+// *********************************************************************/
+
+#ifndef STRUCTURE_H
+#define STRUCTURE_H
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Dense.h"
+
+#define STR_SQUARE 1
+#define STR_DIAGONAL 2
+#define STR_UPPER 4
+#define STR_LOWER 8
+#define STR_BANDED 16
+#define STR_SYMMETRIC 32
+#define STR_SPD 64
+
+typedef struct
+{
+    int flags;
+
+    // Maior distância de um elemento não nulo abaixo e acima da diagonal
+    int lower, upper;
+} Structure;
+
+// Verifica se a estrutura possui tal propriedade
+bool HasStructure(const Structure *structure, int flag)
+{
+    return (structure->flags & flag) != 0;
+}
+
+// Fatoração de Cholesky (a = l * lᵀ) de uma matriz simétrica
+// Retorna falso caso a matriz não seja definida positiva
+bool DenseCholesky(const double *a, double *l, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = 0; j <= i; j++)
+        {
+            double sum = a[(size_t)i * size + j];
+
+            for (int k = 0; k < j; k++)
+                sum -= l[(size_t)i * size + k] * l[(size_t)j * size + k];
+
+            if (i == j)
+            {
+                if (sum <= 0)
+                    return false;
+
+                l[(size_t)i * size + i] = sqrt(sum);
+            }
+            else
+            {
+                l[(size_t)i * size + j] = sum / l[(size_t)j * size + j];
+            }
+        }
+
+        for (int j = i + 1; j < size; j++)
+            l[(size_t)i * size + j] = 0;
+    }
+
+    return true;
+}
+
+// Detecta a estrutura da matriz a (rows x columns)
+void DetectStructure(const double *a, int rows, int columns, Structure *structure)
+{
+    structure->flags = 0;
+    structure->lower = 0;
+    structure->upper = 0;
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < columns; j++)
+        {
+            if (a[(size_t)i * columns + j] == 0)
+                continue;
+
+            if (i - j > structure->lower)
+                structure->lower = i - j;
+
+            if (j - i > structure->upper)
+                structure->upper = j - i;
+        }
+    }
+
+    if (rows != columns || rows == 0)
+        return;
+
+    int size = rows;
+
+    structure->flags |= STR_SQUARE;
+
+    if (structure->lower == 0)
+        structure->flags |= STR_UPPER;
+
+    if (structure->upper == 0)
+        structure->flags |= STR_LOWER;
+
+    if (structure->lower == 0 && structure->upper == 0)
+        structure->flags |= STR_DIAGONAL;
+
+    // A banda só compensa quando ocupa uma fração pequena da matriz
+    if (structure->lower + structure->upper < size / 2)
+        structure->flags |= STR_BANDED;
+
+    if (structure->lower != structure->upper)
+        return;
+
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = i + 1; j < size; j++)
+        {
+            if (a[(size_t)i * size + j] != a[(size_t)j * size + i])
+                return;
+        }
+    }
+
+    structure->flags |= STR_SYMMETRIC;
+
+    // Cholesky de teste: só é possível para matrizes definidas positivas
+    double *l = (double *)malloc((size_t)size * size * sizeof(double));
+
+    if (DenseCholesky(a, l, size))
+        structure->flags |= STR_SPD;
+
+    free(l);
+}
+
+// Fatoração LU com pivoteamento parcial de uma matriz em banda (lower abaixo
+// e upper acima da diagonal), em O(n * lower * (lower + upper)). As trocas
+// de linha alargam a banda superior para lower + upper
+// Retorna o sinal da permutação ou 0 caso a matriz seja singular
+int BandedFactor(double *lu, int *pivots, int size, int lower, int upper)
+{
+    int width = lower + upper;
+    int signal = 1;
+
+    for (int k = 0; k < size; k++)
+    {
+        int last = k + lower < size - 1 ? k + lower : size - 1;
+        int end = k + width < size - 1 ? k + width : size - 1;
+
+        int pivot = k;
+
+        for (int i = k + 1; i <= last; i++)
+        {
+            if (fabs(lu[(size_t)i * size + k]) > fabs(lu[(size_t)pivot * size + k]))
+                pivot = i;
+        }
+
+        pivots[k] = pivot;
+
+        if (lu[(size_t)pivot * size + k] == 0)
+            return 0;
+
+        if (pivot != k)
+        {
+            for (int j = k; j <= end; j++)
+            {
+                double temp = lu[(size_t)k * size + j];
+
+                lu[(size_t)k * size + j] = lu[(size_t)pivot * size + j];
+                lu[(size_t)pivot * size + j] = temp;
+            }
+
+            signal = -signal;
+        }
+
+        for (int i = k + 1; i <= last; i++)
+        {
+            double coefficient = lu[(size_t)i * size + k] / lu[(size_t)k * size + k];
+
+            lu[(size_t)i * size + k] = coefficient;
+
+            for (int j = k + 1; j <= end; j++)
+                lu[(size_t)i * size + j] -= coefficient * lu[(size_t)k * size + j];
+        }
+    }
+
+    return signal;
+}
+
+// Resolve lu * x = b com os fatores de BandedFactor (b é sobrescrito por x)
+void BandedSubstitute(const double *lu, const int *pivots, double *b, int size, int columns, int lower, int upper)
+{
+    int width = lower + upper;
+
+    for (int k = 0; k < size; k++)
+    {
+        if (pivots[k] != k)
+        {
+            for (int j = 0; j < columns; j++)
+            {
+                double temp = b[(size_t)k * columns + j];
+
+                b[(size_t)k * columns + j] = b[(size_t)pivots[k] * columns + j];
+                b[(size_t)pivots[k] * columns + j] = temp;
+            }
+        }
+
+        int last = k + lower < size - 1 ? k + lower : size - 1;
+
+        for (int i = k + 1; i <= last; i++)
+        {
+            for (int j = 0; j < columns; j++)
+                b[(size_t)i * columns + j] -= lu[(size_t)i * size + k] * b[(size_t)k * columns + j];
+        }
+    }
+
+    for (int i = size - 1; i >= 0; i--)
+    {
+        int end = i + width < size - 1 ? i + width : size - 1;
+
+        for (int j = 0; j < columns; j++)
+        {
+            double value = b[(size_t)i * columns + j];
+
+            for (int k = i + 1; k <= end; k++)
+                value -= lu[(size_t)i * size + k] * b[(size_t)k * columns + j];
+
+            b[(size_t)i * columns + j] = value / lu[(size_t)i * size + i];
+        }
+    }
+}
+
+// Calcula o determinante da matriz quadrada a de acordo com sua estrutura:
+// O(n) para matrizes triangulares, Cholesky para as definidas positivas,
+// LU em banda para as matrizes em banda e LU paralela por blocos nos demais casos
+double StructuredDeterminant(const double *a, int size, const Structure *structure)
+{
+    double determinant = 1;
+
+    if (HasStructure(structure, STR_UPPER) || HasStructure(structure, STR_LOWER))
+    {
+        for (int i = 0; i < size; i++)
+            determinant *= a[(size_t)i * size + i];
+
+        return determinant;
+    }
+
+    double *factor = (double *)malloc((size_t)size * size * sizeof(double));
+
+    if (HasStructure(structure, STR_SPD))
+    {
+        DenseCholesky(a, factor, size);
+
+        for (int i = 0; i < size; i++)
+            determinant *= factor[(size_t)i * size + i];
+
+        determinant *= determinant;
+    }
+    else
+    {
+        int *pivots = (int *)malloc((size > 0 ? size : 1) * sizeof(int));
+
+        memcpy(factor, a, (size_t)size * size * sizeof(double));
+
+        if (HasStructure(structure, STR_BANDED))
+            determinant = BandedFactor(factor, pivots, size, structure->lower, structure->upper);
+        else
+            determinant = DenseFactorLU(factor, pivots, size);
+
+        for (int i = 0; i < size && determinant != 0; i++)
+            determinant *= factor[(size_t)i * size + i];
+
+        free(pivots);
+    }
+
+    free(factor);
+
+    return determinant;
+}
+
+// Multiplica x (rows x size) por y (size x columns) aproveitando a estrutura
+// dos operandos: diagonais escalam linhas ou colunas e triangulares ou em
+// banda limitam o intervalo do produto escalar
+// Os caminhos diagonais, de custo quadrático, não verificam o cancelamento
+void StructuredMultiply(const double *x, const Structure *sx, const double *y, const Structure *sy, double *z, int rows, int size, int columns, Task *task = NULL)
+{
+    if (HasStructure(sx, STR_DIAGONAL))
+    {
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = 0; j < columns; j++)
+                z[(size_t)i * columns + j] = x[(size_t)i * size + i] * y[(size_t)i * columns + j];
+        }
+
+        return;
+    }
+
+    if (HasStructure(sy, STR_DIAGONAL))
+    {
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = 0; j < columns; j++)
+                z[(size_t)i * columns + j] = x[(size_t)i * size + j] * y[(size_t)j * columns + j];
+        }
+
+        return;
+    }
+
+    // O produto denso lê y transposta, para que cada elemento de z seja o produto escalar
+    // de duas linhas contíguas; uma y simétrica já é a sua própria transposta
+    if (!HasStructure(sx, STR_UPPER) && !HasStructure(sx, STR_LOWER) && !HasStructure(sx, STR_BANDED))
+    {
+        if (HasStructure(sy, STR_SYMMETRIC))
+        {
+            DenseMultiplyTransposed(x, y, z, rows, size, columns, task);
+            return;
+        }
+
+        double *yt = (double *)malloc(((size_t)size * columns + 1) * sizeof(double));
+
+        DenseTranspose(y, yt, size, columns);
+        DenseMultiplyTransposed(x, yt, z, rows, size, columns, task);
+
+        free(yt);
+        return;
+    }
+
+    // Apenas os elementos entre as distâncias lower e upper da diagonal de x são não nulos
+    for (int i = 0; i < rows && !IsTaskCancelled(task); i++)
+    {
+        double *row = z + (size_t)i * columns;
+
+        for (int j = 0; j < columns; j++)
+            row[j] = 0;
+
+        int first = i - sx->lower > 0 ? i - sx->lower : 0;
+        int last = i + sx->upper < size - 1 ? i + sx->upper : size - 1;
+
+        for (int k = first; k <= last; k++)
+        {
+            double coefficient = x[(size_t)i * size + k];
+            const double *source = y + (size_t)k * columns;
+
+            for (int j = 0; j < columns; j++)
+                row[j] += coefficient * source[j];
+        }
+
+        SetTaskProgress(task, (float)(i + 1) / rows);
+    }
+}
+
+// Resolve o sistema a * x = b aproveitando a estrutura de a: substituição
+// direta para triangulares, Cholesky para definidas positivas, LU em banda
+// para matrizes em banda e LU paralela por blocos nos demais casos
+// Retorna falso caso a matriz seja singular
+bool StructuredSolve(const double *a, const Structure *structure, const double *b, double *x, int size, int columns)
+{
+    if (HasStructure(structure, STR_UPPER) || HasStructure(structure, STR_LOWER))
+    {
+        bool upper = HasStructure(structure, STR_UPPER);
+
+        for (int i = 0; i < size; i++)
+        {
+            if (a[(size_t)i * size + i] == 0)
+                return false;
+        }
+
+        for (int step = 0; step < size; step++)
+        {
+            int i = upper ? size - 1 - step : step;
+
+            int first = upper ? i + 1 : 0;
+            int last = upper ? size - 1 : i - 1;
+
+            for (int j = 0; j < columns; j++)
+            {
+                double value = b[(size_t)i * columns + j];
+
+                for (int k = first; k <= last; k++)
+                    value -= a[(size_t)i * size + k] * x[(size_t)k * columns + j];
+
+                x[(size_t)i * columns + j] = value / a[(size_t)i * size + i];
+            }
+        }
+
+        return true;
+    }
+
+    if (HasStructure(structure, STR_SPD))
+    {
+        double *l = (double *)malloc((size_t)size * size * sizeof(double));
+
+        DenseCholesky(a, l, size);
+
+        // l * w = b seguido de lᵀ * x = w
+        for (int i = 0; i < size; i++)
+        {
+            for (int j = 0; j < columns; j++)
+            {
+                double value = b[(size_t)i * columns + j];
+
+                for (int k = 0; k < i; k++)
+                    value -= l[(size_t)i * size + k] * x[(size_t)k * columns + j];
+
+                x[(size_t)i * columns + j] = value / l[(size_t)i * size + i];
+            }
+        }
+
+        for (int i = size - 1; i >= 0; i--)
+        {
+            for (int j = 0; j < columns; j++)
+            {
+                double value = x[(size_t)i * columns + j];
+
+                for (int k = i + 1; k < size; k++)
+                    value -= l[(size_t)k * size + i] * x[(size_t)k * columns + j];
+
+                x[(size_t)i * columns + j] = value / l[(size_t)i * size + i];
+            }
+        }
+
+        free(l);
+
+        return true;
+    }
+
+    if (!HasStructure(structure, STR_BANDED))
+        return DenseSolve(a, b, x, size, columns);
+
+    double *lu = (double *)malloc((size_t)size * size * sizeof(double));
+    int *pivots = (int *)malloc(size * sizeof(int));
+
+    memcpy(lu, a, (size_t)size * size * sizeof(double));
+    memcpy(x, b, (size_t)size * columns * sizeof(double));
+
+    bool regular = BandedFactor(lu, pivots, size, structure->lower, structure->upper) != 0;
+
+    if (regular)
+        BandedSubstitute(lu, pivots, x, size, columns, structure->lower, structure->upper);
+
+    free(lu);
+    free(pivots);
+
+    return regular;
+}
+
+#endif
@@ -0,0 +1,65 @@
+/*********************************************************************
+// Task.h
+// Estado compartilhado entre um cálculo em segundo plano e a interface:
+// o pedido de cancelamento e o progresso. As rotinas numéricas recebem
+// um Task opcional e, quando ele é fornecido, verificam o cancelamento
+// entre os blocos de trabalho e informam a fração já concluída.
+// *********************************************************************/
+
+#ifndef TASK_H
+#define TASK_H
+
+#include <atomic>
+#include <stddef.h>
+
+typedef struct
+{
+    std::atomic<bool> cancelled;
+    std::atomic<float> progress;
+
+    // Intervalo do progresso total ocupado pela etapa atual
+    float first, last;
+} Task;
+
+// Prepara a tarefa para um novo cálculo
+void InitializeTask(Task *task)
+{
+    task->cancelled = false;
+    task->progress = 0;
+
+    task->first = 0;
+    task->last = 1;
+}
+
+// Verifica se foi pedido o cancelamento da tarefa
+bool IsTaskCancelled(const Task *task)
+{
+    return task != NULL && task->cancelled;
+}
+
+// Pede o cancelamento da tarefa, que é interrompida no próximo ponto de verificação
+void CancelTask(Task *task)
+{
+    if (task != NULL)
+        task->cancelled = true;
+}
+
+// Define o intervalo do progresso total ocupado pelas próximas chamadas de SetTaskProgress
+void SetTaskStage(Task *task, float first, float last)
+{
+    if (task == NULL)
+        return;
+
+    task->first = first;
+    task->last = last;
+    task->progress = first;
+}
+
+// Informa a fração concluída (entre 0 e 1) da etapa atual
+void SetTaskProgress(Task *task, float fraction)
+{
+    if (task != NULL)
+        task->progress = task->first + (task->last - task->first) * fraction;
+}
+
+#endif
@@ -0,0 +1,236 @@
+/*********************************************************************
+// Trace.h
+// Registro das operações elementares de linha feitas por uma eliminação
+// (troca, divisão e subtração de um múltiplo de outra linha), para que
+// qualquer passo intermediário possa ser exibido depois. Cópias completas
+// da matriz (quadros-chave) são guardadas em intervalos regulares dentro
+// de um orçamento de memória; um passo é reconstruído a partir do último
+// quadro-chave anterior a ele, ou do passo exibido antes, caso este esteja
+// no caminho, repetindo as operações registradas.
+// *********************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Memória máxima dos quadros-chave
+#define TRC_KEYFRAME_BUDGET (64 * 1024 * 1024)
+
+// Menor quantidade de operações entre dois quadros-chave
+#define TRC_MIN_INTERVAL 256
+
+#define TRC_SWAP 0
+#define TRC_SCALE 1
+#define TRC_AXPY 2
+
+// Uma operação de linha em 16 bytes (a linha source cabe em 16 bits, até 32767 linhas):
+// - TRC_SWAP: troca as linhas target e source
+// - TRC_SCALE: divide a linha target por coefficient
+// - TRC_AXPY: subtrai coefficient vezes a linha source da linha target
+typedef struct
+{
+    double coefficient;
+    int32_t target;
+    int16_t source;
+    int16_t type;
+} TraceOperation;
+
+typedef struct
+{
+    int rows, columns;
+
+    TraceOperation *operations;
+    int count, capacity;
+
+    // Cópias da matriz antes da operação keyframeSteps[k]
+    double **keyframes;
+    int *keyframeSteps;
+    int keyframeCount, keyframeCapacity;
+
+    int interval;
+
+    // Matriz reconstruída após stateStep operações (-1 caso nenhuma)
+    double *state;
+    int stateStep;
+} Trace;
+
+// Inicia o registro de uma eliminação sobre a matriz z, que vira o primeiro quadro-chave
+// expected é uma estimativa da quantidade de operações, usada para espaçar os quadros-chave
+Trace *CreateTrace(const double *z, int rows, int columns, long long expected)
+{
+    Trace *trace = (Trace *)malloc(sizeof(Trace));
+
+    size_t size = (size_t)rows * columns * sizeof(double);
+
+    trace->rows = rows;
+    trace->columns = columns;
+
+    trace->count = 0;
+    trace->capacity = 1024;
+    trace->operations = (TraceOperation *)malloc(trace->capacity * sizeof(TraceOperation));
+
+    long long keyframes = size > 0 ? TRC_KEYFRAME_BUDGET / size : 1;
+
+    if (keyframes < 1)
+        keyframes = 1;
+
+    long long interval = expected / keyframes + 1;
+
+    trace->interval = interval > TRC_MIN_INTERVAL ? (int)interval : TRC_MIN_INTERVAL;
+
+    trace->keyframeCount = 1;
+    trace->keyframeCapacity = 16;
+    trace->keyframes = (double **)malloc(trace->keyframeCapacity * sizeof(double *));
+    trace->keyframeSteps = (int *)malloc(trace->keyframeCapacity * sizeof(int));
+
+    trace->keyframes[0] = (double *)malloc(size + sizeof(double));
+    trace->keyframeSteps[0] = 0;
+    memcpy(trace->keyframes[0], z, size);
+
+    trace->state = (double *)malloc(size + sizeof(double));
+    trace->stateStep = -1;
+
+    return trace;
+}
+
+// Libera a memória ocupada pelo registro
+void FreeTrace(Trace *trace)
+{
+    if (trace == NULL)
+        return;
+
+    for (int k = 0; k < trace->keyframeCount; k++)
+        free(trace->keyframes[k]);
+
+    free(trace->keyframes);
+    free(trace->keyframeSteps);
+    free(trace->operations);
+    free(trace->state);
+    free(trace);
+}
+
+// Aplica uma operação de linha à matriz z
+void ApplyTraceOperation(double *z, int columns, const TraceOperation *operation)
+{
+    double *target = z + (size_t)operation->target * columns;
+    double *source = z + (size_t)operation->source * columns;
+
+    switch (operation->type)
+    {
+    case TRC_SWAP:
+        for (int j = 0; j < columns; j++)
+        {
+            double temp = target[j];
+
+            target[j] = source[j];
+            source[j] = temp;
+        }
+        break;
+    case TRC_SCALE:
+        for (int j = 0; j < columns; j++)
+            target[j] /= operation->coefficient;
+        break;
+    case TRC_AXPY:
+        for (int j = 0; j < columns; j++)
+            target[j] -= operation->coefficient * source[j];
+        break;
+    }
+}
+
+// Registra uma operação que está prestes a ser aplicada à matriz z (NULL ignora o registro)
+// A matriz z é guardada como quadro-chave quando o intervalo é atingido
+void RecordTraceOperation(Trace *trace, const double *z, int type, int target, int source, double coefficient)
+{
+    if (trace == NULL)
+        return;
+
+    if (trace->count > 0 && trace->count % trace->interval == 0)
+    {
+        if (trace->keyframeCount == trace->keyframeCapacity)
+        {
+            trace->keyframeCapacity *= 2;
+            trace->keyframes = (double **)realloc(trace->keyframes, trace->keyframeCapacity * sizeof(double *));
+            trace->keyframeSteps = (int *)realloc(trace->keyframeSteps, trace->keyframeCapacity * sizeof(int));
+        }
+
+        size_t size = (size_t)trace->rows * trace->columns * sizeof(double);
+
+        double *keyframe = (double *)malloc(size + sizeof(double));
+        memcpy(keyframe, z, size);
+
+        trace->keyframes[trace->keyframeCount] = keyframe;
+        trace->keyframeSteps[trace->keyframeCount] = trace->count;
+        trace->keyframeCount++;
+    }
+
+    if (trace->count == trace->capacity)
+    {
+        trace->capacity *= 2;
+        trace->operations = (TraceOperation *)realloc(trace->operations, trace->capacity * sizeof(TraceOperation));
+    }
+
+    TraceOperation *operation = &trace->operations[trace->count++];
+
+    operation->coefficient = coefficient;
+    operation->target = target;
+    operation->source = (int16_t)source;
+    operation->type = (int16_t)type;
+}
+
+// Reconstrói a matriz após tal quantidade de operações (de 0 até trace->count)
+const double *SeekTrace(Trace *trace, int step)
+{
+    if (step < 0)
+        step = 0;
+
+    if (step > trace->count)
+        step = trace->count;
+
+    // Último quadro-chave antes do passo, por busca binária
+    int low = 0, high = trace->keyframeCount - 1;
+
+    while (low < high)
+    {
+        int middle = (low + high + 1) / 2;
+
+        if (trace->keyframeSteps[middle] <= step)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+
+    // O passo exibido antes serve de ponto de partida caso esteja entre o quadro-chave e o destino
+    if (trace->stateStep < trace->keyframeSteps[low] || trace->stateStep > step)
+    {
+        memcpy(trace->state, trace->keyframes[low], (size_t)trace->rows * trace->columns * sizeof(double));
+        trace->stateStep = trace->keyframeSteps[low];
+    }
+
+    for (; trace->stateStep < step; trace->stateStep++)
+        ApplyTraceOperation(trace->state, trace->columns, &trace->operations[trace->stateStep]);
+
+    return trace->state;
+}
+
+// Escreve a descrição de uma operação (por exemplo "L2 <-> L5")
+void DescribeTraceOperation(const TraceOperation *operation, char *destination)
+{
+    switch (operation->type)
+    {
+    case TRC_SWAP:
+        sprintf(destination, "L%d <-> L%d", operation->target + 1, operation->source + 1);
+        break;
+    case TRC_SCALE:
+        sprintf(destination, "L%d <- L%d / %g", operation->target + 1, operation->target + 1, operation->coefficient);
+        break;
+    case TRC_AXPY:
+        sprintf(destination, "L%d <- L%d - %g L%d", operation->target + 1, operation->target + 1, operation->coefficient, operation->source + 1);
+        break;
+    }
+}
+
+#endif
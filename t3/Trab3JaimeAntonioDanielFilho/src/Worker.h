@@ -0,0 +1,175 @@
+/*********************************************************************
+// Worker.h
+// Thread de segundo plano que executa um trabalho por vez. Um novo envio
+// substitui o trabalho pendente e cancela o que estiver em execução, de
+// forma que apenas o resultado do envio mais recente é entregue. A
+// interface consulta o resultado a cada quadro, sem nunca esperar (exceto
+// ao gravar a sessão, que aguarda o trabalho em andamento).
+// *********************************************************************/
+
+#ifndef WORKER_H
+#define WORKER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <stddef.h>
+#include <thread>
+
+#include "Task.h"
+
+// Executa o trabalho, verificando o cancelamento da tarefa
+typedef void (*WorkFunction)(void *work, Task *task);
+
+// Libera a memória de um trabalho descartado ou já consumido
+typedef void (*ReleaseFunction)(void *work);
+
+typedef struct
+{
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    WorkFunction execute;
+    ReleaseFunction release;
+
+    void *pending;  // enviado e ainda não iniciado
+    void *running;  // em execução
+    void *finished; // concluído e ainda não consumido
+
+    Task task;
+    bool stopping;
+} Worker;
+
+// Laço da thread: aguarda um trabalho pendente e o executa fora da trava
+void RunWorker(Worker *worker)
+{
+    std::unique_lock<std::mutex> lock(worker->mutex);
+
+    while (true)
+    {
+        worker->condition.wait(lock, [worker]() { return worker->pending != NULL || worker->stopping; });
+
+        if (worker->stopping)
+            break;
+
+        worker->running = worker->pending;
+        worker->pending = NULL;
+
+        InitializeTask(&worker->task);
+
+        lock.unlock();
+        worker->execute(worker->running, &worker->task);
+        lock.lock();
+
+        // Um trabalho cancelado foi substituído por outro e seu resultado é descartado
+        if (IsTaskCancelled(&worker->task))
+        {
+            worker->release(worker->running);
+        }
+        else
+        {
+            if (worker->finished != NULL)
+                worker->release(worker->finished);
+
+            worker->finished = worker->running;
+        }
+
+        worker->running = NULL;
+        worker->condition.notify_all();
+    }
+}
+
+// Inicia a thread de segundo plano
+void StartWorker(Worker *worker, WorkFunction execute, ReleaseFunction release)
+{
+    worker->execute = execute;
+    worker->release = release;
+
+    worker->pending = NULL;
+    worker->running = NULL;
+    worker->finished = NULL;
+    worker->stopping = false;
+
+    InitializeTask(&worker->task);
+
+    worker->thread = std::thread(RunWorker, worker);
+}
+
+// Envia um trabalho, descartando o pendente e cancelando o que estiver em execução
+void SubmitWork(Worker *worker, void *work)
+{
+    std::lock_guard<std::mutex> lock(worker->mutex);
+
+    if (worker->pending != NULL)
+        worker->release(worker->pending);
+
+    if (worker->running != NULL)
+        CancelTask(&worker->task);
+
+    worker->pending = work;
+    worker->condition.notify_all();
+}
+
+// Retorna o último trabalho concluído (ou NULL), que passa a ser do chamador
+void *TakeFinishedWork(Worker *worker)
+{
+    std::lock_guard<std::mutex> lock(worker->mutex);
+
+    void *work = worker->finished;
+    worker->finished = NULL;
+
+    return work;
+}
+
+// Aguarda até que não exista nenhum trabalho pendente ou em execução
+void WaitWorker(Worker *worker)
+{
+    std::unique_lock<std::mutex> lock(worker->mutex);
+
+    worker->condition.wait(lock, [worker]() { return worker->pending == NULL && worker->running == NULL; });
+}
+
+// Verifica se existe algum trabalho pendente ou em execução
+bool IsWorkerBusy(Worker *worker)
+{
+    std::lock_guard<std::mutex> lock(worker->mutex);
+
+    return worker->pending != NULL || worker->running != NULL;
+}
+
+// Retorna a fração concluída do trabalho em execução
+float WorkerProgress(Worker *worker)
+{
+    std::lock_guard<std::mutex> lock(worker->mutex);
+
+    return worker->running != NULL ? (float)worker->task.progress : 0;
+}
+
+// Cancela o trabalho em execução, encerra a thread e libera os trabalhos restantes
+void StopWorker(Worker *worker)
+{
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+
+        worker->stopping = true;
+
+        if (worker->running != NULL)
+            CancelTask(&worker->task);
+
+        worker->condition.notify_all();
+    }
+
+    if (worker->thread.joinable())
+        worker->thread.join();
+
+    if (worker->pending != NULL)
+        worker->release(worker->pending);
+
+    if (worker->finished != NULL)
+        worker->release(worker->finished);
+
+    worker->pending = NULL;
+    worker->finished = NULL;
+}
+
+#endif
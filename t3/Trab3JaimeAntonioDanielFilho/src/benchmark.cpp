@@ -0,0 +1,810 @@
+/*********************************************************************
+// The Matrix - Benchmark
+// Mede o desempenho das operações da calculadora fora da interface.
+//
+// Cada operação é executada para vários tamanhos, formatos (quadrada,
+// larga e alta), tipos de dados e quantidades de threads. Cada caso é
+// repetido até atingir um número mínimo de repetições e um tempo mínimo,
+// e são reportados o tempo por operação (mínimo, mediana, média e desvio
+// padrão), GFLOP/s e bytes/s calculados sobre a mediana. Os resultados
+// são exibidos em uma tabela e gravados em JSON para comparação entre
+// compilações. O caso multiply-verified inclui a verificação de Freivalds,
+// cujo resultado é gravado no JSON e, quando falha, avisado na saída de erro.
+// O produto em double lê Y transposta; o caso multiply-symmetric usa uma Y
+// simétrica, que já é a sua própria transposta e dispensa a cópia.
+// Os casos complexos contam as operações reais do produto direto (8 por
+// multiplicação complexa), então o método 3M aparece como GFLOP/s maior.
+// As entradas são geradas em paralelo pelos fluxos independentes de
+// Random.h (iguais para uma semente qualquer que seja o número de threads),
+// e o caso random mede esse preenchimento para cada distribuição.
+//
+// Opções:
+// --sizes 4,8,16       tamanhos (n) das matrizes
+// --threads 1,2,4      quantidades de threads (0 usa todos os núcleos)
+// --repetitions 5      mínimo de repetições por caso
+// --min-time 0.2       tempo mínimo (em segundos) por caso
+// --filter multiply    executa apenas as operações cujo nome contém o texto
+// --output bench.json  arquivo de saída
+// *********************************************************************/
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "Analysis.h"
+#include "Matrix.h"
+#include "Operations.h"
+
+#define BENCH_MAX_LIST 32
+#define BENCH_MAX_REPETITIONS 1000
+
+// Maiores ordens para os determinantes por cofatores (O(n!)) e exato (multimodular)
+#define BENCH_COFACTOR_MAX 9
+#define BENCH_EXACT_MAX 128
+
+// Maior dimensão para o Gauss Jordan exato, cujos valores crescem com o tamanho
+#define BENCH_RATIONAL_MAX 64
+
+// Expoente usado na potência
+#define BENCH_EXPONENT 10
+
+#define SHAPE_NUM 3
+
+#define SHAPE_SQUARE 0
+#define SHAPE_WIDE 1
+#define SHAPE_TALL 2
+
+typedef struct
+{
+    int sizes[BENCH_MAX_LIST];
+    int sizeCount;
+
+    int threads[BENCH_MAX_LIST];
+    int threadCount;
+
+    int repetitions;
+    double minTime;
+
+    const char *filter;
+    const char *output;
+} BenchmarkOptions;
+
+// Entradas de um caso: X é rows x size e Y é size x columns
+typedef struct
+{
+    const char *operation;
+    const char *shape;
+    const char *type;
+
+    int rows, size, columns;
+    int threads;
+
+    double *x, *y;
+    Structure structureX, structureY;
+
+    // Quantidade de operações de ponto flutuante e de bytes lidos e escritos por execução
+    double flops;
+    double bytes;
+
+    // Resultado da verificação de Freivalds da última execução (-1 caso não verificada)
+    int verified;
+    double verificationError;
+} BenchmarkCase;
+
+typedef struct
+{
+    int repetitions;
+
+    double minimum;
+    double median;
+    double mean;
+    double deviation;
+} BenchmarkResult;
+
+const char *shapeNames[SHAPE_NUM] = {"quadrada", "larga", "alta"};
+const char *precisionNames[PRECISION_NUM] = {"double", "int16", "int8"};
+
+FILE *output = NULL;
+bool firstResult = true;
+
+// Lê uma lista de inteiros separados por vírgula
+int ParseList(const char *text, int *list)
+{
+    int count = 0;
+
+    while (*text != '\0' && count < BENCH_MAX_LIST)
+    {
+        char *end;
+        list[count++] = (int)strtol(text, &end, 10);
+
+        text = *end == ',' ? end + 1 : end;
+
+        if (end == text && *end != '\0')
+            break;
+    }
+
+    return count;
+}
+
+// Lê as opções da linha de comando
+void ParseOptions(int argc, char **argv, BenchmarkOptions *options)
+{
+    options->sizeCount = ParseList("4,8,16,32,64,128,256,512", options->sizes);
+
+    options->threads[0] = 1;
+    options->threads[1] = 0;
+    options->threadCount = std::thread::hardware_concurrency() > 1 ? 2 : 1;
+
+    options->repetitions = 5;
+    options->minTime = 0.2;
+
+    options->filter = "";
+    options->output = "benchmark.json";
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--sizes") == 0)
+            options->sizeCount = ParseList(argv[i + 1], options->sizes);
+        else if (strcmp(argv[i], "--threads") == 0)
+            options->threadCount = ParseList(argv[i + 1], options->threads);
+        else if (strcmp(argv[i], "--repetitions") == 0)
+            options->repetitions = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--min-time") == 0)
+            options->minTime = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--filter") == 0)
+            options->filter = argv[i + 1];
+        else if (strcmp(argv[i], "--output") == 0)
+            options->output = argv[i + 1];
+        else
+            fprintf(stderr, "opcao desconhecida: %s\n", argv[i]);
+    }
+
+    if (options->repetitions < 1)
+        options->repetitions = 1;
+
+    if (options->repetitions > BENCH_MAX_REPETITIONS)
+        options->repetitions = BENCH_MAX_REPETITIONS;
+}
+
+// Retorna o tempo atual em nanossegundos
+double Now()
+{
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Ordena os tempos para obter a mediana
+int CompareTimes(const void *a, const void *b)
+{
+    double difference = *(const double *)a - *(const double *)b;
+
+    return (difference > 0) - (difference < 0);
+}
+
+// Calcula as estatísticas dos tempos medidos
+void Summarize(double *times, int count, BenchmarkResult *result)
+{
+    qsort(times, count, sizeof(double), CompareTimes);
+
+    double sum = 0;
+
+    for (int k = 0; k < count; k++)
+        sum += times[k];
+
+    double mean = sum / count;
+    double variance = 0;
+
+    for (int k = 0; k < count; k++)
+        variance += (times[k] - mean) * (times[k] - mean);
+
+    result->repetitions = count;
+    result->minimum = times[0];
+    result->median = count % 2 ? times[count / 2] : (times[count / 2 - 1] + times[count / 2]) / 2;
+    result->mean = mean;
+    result->deviation = count > 1 ? sqrt(variance / (count - 1)) : 0;
+}
+
+// Exibe e grava o resultado de um caso
+void Report(const BenchmarkCase *bench, const BenchmarkResult *result)
+{
+    double seconds = result->median * 1e-9;
+
+    double gflops = bench->flops > 0 ? bench->flops / seconds * 1e-9 : 0;
+    double bandwidth = bench->bytes / seconds;
+
+    printf("%-16s %-9s %-7s %5d x %-5d %3d %6d %14.0f %14.0f %9.3f %12.3e\n",
+           bench->operation, bench->shape, bench->type,
+           bench->rows, bench->columns, bench->threads, result->repetitions,
+           result->median, result->deviation, gflops, bandwidth);
+
+    fprintf(output, "%s\n    {\"operation\": \"%s\", \"shape\": \"%s\", \"type\": \"%s\", "
+                    "\"rows\": %d, \"size\": %d, \"columns\": %d, \"threads\": %d, \"repetitions\": %d, "
+                    "\"ns_min\": %.0f, \"ns_median\": %.0f, \"ns_mean\": %.0f, \"ns_stddev\": %.0f, "
+                    "\"gflops\": %.6f, \"bytes_per_second\": %.6e",
+            firstResult ? "" : ",",
+            bench->operation, bench->shape, bench->type,
+            bench->rows, bench->size, bench->columns, bench->threads, result->repetitions,
+            result->minimum, result->median, result->mean, result->deviation,
+            gflops, bandwidth);
+
+    if (bench->verified != -1)
+    {
+        fprintf(output, ", \"verified\": %s, \"verification_error\": %.6e",
+                bench->verified ? "true" : "false", bench->verificationError);
+
+        if (!bench->verified)
+        {
+            fprintf(stderr, "%s %s %s %d x %d: verificacao de Freivalds falhou (erro relativo %.3e)\n",
+                    bench->operation, bench->shape, bench->type, bench->rows, bench->columns, bench->verificationError);
+        }
+    }
+
+    fprintf(output, "}");
+
+    firstResult = false;
+}
+
+// Executa o caso até atingir o mínimo de repetições e de tempo
+// prepare roda fora da medição e run é a parte medida
+template <typename Prepare, typename Run>
+void Measure(const BenchmarkOptions *options, const BenchmarkCase *bench, Prepare prepare, Run run)
+{
+    static double times[BENCH_MAX_REPETITIONS];
+
+    // Uma execução de aquecimento preenche as caches e aloca os primos e threads
+    prepare();
+    run();
+
+    double total = 0;
+    int count = 0;
+
+    while (count < BENCH_MAX_REPETITIONS && (count < options->repetitions || total < options->minTime * 1e9))
+    {
+        prepare();
+
+        double start = Now();
+        run();
+        times[count] = Now() - start;
+
+        total += times[count];
+        count++;
+    }
+
+    BenchmarkResult result;
+    Summarize(times, count, &result);
+
+    Report(bench, &result);
+}
+
+// Preenche um bloco das entradas com inteiros em [-10, 10]
+void FillInputBlock(Random *random, double *destination, long long length)
+{
+    FillRandomIntegers(random, destination, length, -10, 10);
+}
+
+// Gera entradas inteiras aleatórias em [-10, 10] para o caso
+void PrepareInputs(BenchmarkCase *bench, int rows, int size, int columns)
+{
+    bench->rows = rows;
+    bench->size = size;
+    bench->columns = columns;
+
+    // Y comporta tanto o formato da multiplicação (size x columns) quanto o de X
+    size_t capacity = (size_t)(rows > size ? rows : size) * (size > columns ? size : columns);
+
+    bench->x = (double *)malloc(((size_t)rows * size + 1) * sizeof(double));
+    bench->y = (double *)malloc((capacity + 1) * sizeof(double));
+
+    FillRandomParallel(&globalRandom, bench->x, (long long)rows * size, FillInputBlock);
+    FillRandomParallel(&globalRandom, bench->y, (long long)capacity, FillInputBlock);
+
+    DetectStructure(bench->x, rows, size, &bench->structureX);
+    DetectStructure(bench->y, size, columns, &bench->structureY);
+}
+
+// Torna X diagonalmente dominante (e simétrica, se pedido) para que os métodos iterativos convirjam
+void ConditionInputs(BenchmarkCase *bench, bool symmetric)
+{
+    int n = bench->size;
+
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; symmetric && j < i; j++)
+            bench->x[(size_t)i * n + j] = bench->x[(size_t)j * n + i];
+
+        bench->x[(size_t)i * n + i] = 10.0 * n;
+    }
+
+    DetectStructure(bench->x, n, n, &bench->structureX);
+}
+
+// Libera as entradas do caso
+void FreeInputs(BenchmarkCase *bench)
+{
+    free(bench->x);
+    free(bench->y);
+}
+
+// Verifica se a operação passa pelo filtro da linha de comando
+bool Selected(const BenchmarkOptions *options, const char *operation)
+{
+    return strstr(operation, options->filter) != NULL;
+}
+
+// Mede uma operação da calculadora executada pelo mesmo caminho da interface
+// Com verify, o produto é conferido pela verificação de Freivalds dentro da medição
+// Com complex, as partes imaginárias de X e de Y são tiradas dos valores de Y
+// Com exact, o Gauss Jordan é feito em frações, como no modo exato da interface
+void MeasureOperation(const BenchmarkOptions *options, BenchmarkCase *bench, int operation, int precision, bool iterative, bool verify = false, bool complex = false, bool exact = false)
+{
+    bench->verified = -1;
+
+    Job *job = NULL;
+
+    Measure(
+        options, bench,
+        [&]()
+        {
+            if (job != NULL)
+                FreeJob(job);
+
+            bool unary = IsUnaryOperation(operation);
+
+            // Nas operações elemento a elemento e nos sistemas, Y tem o formato exigido pela operação
+            int rowsY = unary ? 0 : operation == OPERATION_MULTIPLY ? bench->size : bench->rows;
+            int columnsY = unary ? 0 : operation == OPERATION_MULTIPLY ? bench->columns : bench->size;
+
+            job = CreateJob(operation, bench->rows, bench->size, rowsY, columnsY);
+
+            job->precision = precision;
+            job->iterative = iterative;
+            job->verify = verify;
+            job->exact = exact;
+            job->exponent = BENCH_EXPONENT;
+
+            memcpy(job->x, bench->x, (size_t)bench->rows * bench->size * sizeof(double));
+            memcpy(job->y, bench->y, (size_t)rowsY * columnsY * sizeof(double));
+
+            if (complex)
+            {
+                SetJobComplex(job);
+
+                memcpy(job->xi, bench->y, (size_t)bench->rows * bench->size * sizeof(double));
+                memcpy(job->yi, bench->y, (size_t)rowsY * columnsY * sizeof(double));
+            }
+
+            job->structureX = bench->structureX;
+            job->structureY = bench->structureY;
+        },
+        [&]()
+        {
+            ExecuteJob(job, NULL);
+
+            if (verify)
+            {
+                bench->verified = job->verified;
+                bench->verificationError = job->verificationError;
+            }
+        });
+
+    if (!job->success)
+        fprintf(stderr, "%s falhou: %s\n", bench->operation, job->error);
+
+    FreeJob(job);
+}
+
+// Executa as operações da calculadora para um tamanho, formato e quantidade de threads
+void RunOperations(const BenchmarkOptions *options, int n, int shape, int threads)
+{
+    int rows = shape == SHAPE_TALL ? 2 * n : n;
+    int size = n;
+    int columns = shape == SHAPE_WIDE ? 2 * n : n;
+
+    BenchmarkCase bench;
+    bench.shape = shapeNames[shape];
+    bench.threads = threads;
+    bench.verified = -1;
+
+    PrepareInputs(&bench, rows, size, columns);
+
+    double r = rows, s = size, c = columns;
+
+    for (int p = 0; p < PRECISION_NUM; p++)
+    {
+        bench.operation = "multiply";
+        bench.type = precisionNames[p];
+
+        // Nas precisões inteiras, o produto em double também é calculado para o erro
+        int width = p == PRECISION_DOUBLE ? 8 : p == PRECISION_INT16 ? 2 : 1;
+
+        bench.flops = 2 * r * s * c * (p == PRECISION_DOUBLE ? 1 : 2);
+        bench.bytes = width * (r * s + s * c) + 8 * r * c;
+
+        if (Selected(options, bench.operation))
+            MeasureOperation(options, &bench, OPERATION_MULTIPLY, p, false);
+    }
+
+    // A verificação lê X, Y e Z uma vez e faz 2 operações por vetor e elemento de cada um
+    bench.operation = "multiply-verified";
+    bench.type = precisionNames[PRECISION_DOUBLE];
+    bench.flops = 2 * r * s * c + 2.0 * FREIVALDS_TRIALS * (r * s + s * c + r * c);
+    bench.bytes = 16 * (r * s + s * c + r * c);
+
+    if (Selected(options, bench.operation))
+        MeasureOperation(options, &bench, OPERATION_MULTIPLY, PRECISION_DOUBLE, false, true);
+
+    bench.operation = "multiply";
+    bench.type = "complex";
+    bench.flops = 8 * r * s * c;
+    bench.bytes = 16 * (r * s + s * c + r * c);
+
+    if (Selected(options, bench.operation))
+        MeasureOperation(options, &bench, OPERATION_MULTIPLY, PRECISION_DOUBLE, false, false, true);
+
+    bench.type = "double";
+
+    // Com Y simétrica, o produto a lê como a sua própria transposta, sem a cópia transposta
+    bench.operation = "multiply-symmetric";
+    bench.flops = 2 * r * s * c;
+    bench.bytes = 8 * (r * s + s * c + r * c);
+
+    if (shape == SHAPE_SQUARE && Selected(options, bench.operation))
+    {
+        for (int i = 0; i < n; i++)
+        {
+            for (int j = 0; j < i; j++)
+                bench.y[(size_t)i * n + j] = bench.y[(size_t)j * n + i];
+        }
+
+        DetectStructure(bench.y, n, n, &bench.structureY);
+
+        MeasureOperation(options, &bench, OPERATION_MULTIPLY, PRECISION_DOUBLE, false);
+    }
+
+    // As demais operações usam X com o formato do caso (rows x columns) e Y do mesmo tamanho
+    FreeInputs(&bench);
+    PrepareInputs(&bench, rows, columns, columns);
+
+    s = columns;
+
+    bench.operation = "add";
+    bench.flops = r * s;
+    bench.bytes = 24 * r * s;
+
+    if (Selected(options, bench.operation))
+        MeasureOperation(options, &bench, OPERATION_ADD, PRECISION_DOUBLE, false);
+
+    bench.operation = "subtract";
+
+    if (Selected(options, bench.operation))
+        MeasureOperation(options, &bench, OPERATION_SUBTRACT, PRECISION_DOUBLE, false);
+
+    bench.operation = "transpose";
+    bench.flops = 0;
+    bench.bytes = 16 * r * s;
+
+    if (Selected(options, bench.operation))
+        MeasureOperation(options, &bench, OPERATION_TRANSPOSE, PRECISION_DOUBLE, false);
+
+    // Cada linha elimina o pivo das demais rows - 1 linhas
+    bench.operation = "gauss-jordan";
+    bench.flops = 2 * r * (r - 1) * s;
+    bench.bytes = 16 * r * s;
+
+    if (Selected(options, bench.operation))
+        MeasureOperation(options, &bench, OPERATION_GAUSS_JORDAN, PRECISION_DOUBLE, false);
+
+    // Mesmas operações em inteiros; a partir de algumas dezenas de linhas os valores passam a usar BigInt
+    if (r <= BENCH_RATIONAL_MAX && s <= BENCH_RATIONAL_MAX && Selected(options, bench.operation))
+    {
+        bench.type = "exato";
+
+        MeasureOperation(options, &bench, OPERATION_GAUSS_JORDAN, PRECISION_DOUBLE, false, false, false, true);
+
+        bench.type = "double";
+    }
+
+    if (shape == SHAPE_SQUARE)
+    {
+        int multiplications = 0;
+
+        for (unsigned int k = BENCH_EXPONENT; k > 0; k >>= 1)
+            multiplications += (k & 1) + (k > 1);
+
+        bench.operation = "power";
+        bench.flops = 2 * s * s * s * multiplications;
+        bench.bytes = 16 * s * s;
+
+        if (Selected(options, bench.operation))
+            MeasureOperation(options, &bench, OPERATION_POWER, PRECISION_DOUBLE, false);
+
+        // Padé de grau 6 (6 produtos e uma solução com n colunas) seguido dos quadrados
+        double norm = 0;
+
+        for (int j = 0; j < n; j++)
+        {
+            double sum = 0;
+
+            for (int i = 0; i < n; i++)
+                sum += fabs(bench.x[(size_t)i * n + j]);
+
+            norm = fmax(norm, sum);
+        }
+
+        int squarings = norm > 0.5 ? (int)ceil(log2(norm / 0.5)) : 0;
+
+        bench.operation = "exponential";
+        bench.flops = 2 * s * s * s * (DNS_PADE_DEGREE + squarings) + 8.0 / 3 * s * s * s;
+        bench.bytes = 16 * s * s;
+
+        if (Selected(options, bench.operation))
+            MeasureOperation(options, &bench, OPERATION_EXPONENTIAL, PRECISION_DOUBLE, false);
+
+        ConditionInputs(&bench, false);
+
+        bench.operation = "solve";
+        bench.flops = 2.0 / 3 * s * s * s + 2 * s * s * s;
+        bench.bytes = 24 * s * s;
+
+        if (Selected(options, bench.operation))
+            MeasureOperation(options, &bench, OPERATION_SOLVE, PRECISION_DOUBLE, false);
+
+        // Os métodos iterativos não têm uma contagem fixa de operações
+        bench.operation = "solve-gmres";
+        bench.flops = 0;
+
+        if (Selected(options, bench.operation))
+            MeasureOperation(options, &bench, OPERATION_SOLVE, PRECISION_DOUBLE, true);
+
+        ConditionInputs(&bench, true);
+
+        bench.operation = "solve-cg";
+
+        if (Selected(options, bench.operation))
+            MeasureOperation(options, &bench, OPERATION_SOLVE, PRECISION_DOUBLE, true);
+    }
+
+    FreeInputs(&bench);
+}
+
+// Executa os cálculos de determinante para uma ordem e quantidade de threads
+void RunDeterminants(const BenchmarkOptions *options, int n, int threads)
+{
+    BenchmarkCase bench;
+    bench.shape = shapeNames[SHAPE_SQUARE];
+    bench.type = "double";
+    bench.threads = threads;
+    bench.verified = -1;
+
+    PrepareInputs(&bench, n, n, n);
+
+    double s = n;
+
+    bench.operation = "det-lu";
+    bench.flops = 2.0 / 3 * s * s * s;
+    bench.bytes = 8 * s * s;
+
+    volatile double determinant = 0;
+
+    if (Selected(options, bench.operation))
+    {
+        Measure(
+            options, &bench, []() {},
+            [&]()
+            {
+                determinant = StructuredDeterminant(bench.x, n, &bench.structureX);
+            });
+    }
+
+    // A parte imaginária reaproveita os valores de Y
+    if (Selected(options, bench.operation))
+    {
+        volatile double imaginary = 0;
+
+        bench.type = "complex";
+        bench.flops = 8.0 / 3 * s * s * s;
+        bench.bytes = 16 * s * s;
+
+        Measure(
+            options, &bench, []() {},
+            [&]()
+            {
+                double real, part;
+                ComplexDeterminant(bench.x, bench.y, n, &real, &part);
+
+                determinant = real;
+                imaginary = part;
+            });
+
+        bench.type = "double";
+    }
+
+    // Hessenberg por Householder (10/3 n^3) e a recorrência do polinômio (n^3 / 3)
+    if (Selected(options, "charpoly"))
+    {
+        std::vector<double> h((size_t)n * n + 1), coefficients(n + 1);
+
+        bench.operation = "charpoly";
+        bench.flops = 11.0 / 3 * s * s * s;
+        bench.bytes = 16 * s * s;
+
+        Measure(
+            options, &bench,
+            [&]()
+            {
+                memcpy(h.data(), bench.x, (size_t)n * n * sizeof(double));
+            },
+            [&]()
+            {
+                ReduceHessenberg(h.data(), n);
+                HessenbergPolynomial(h.data(), n, coefficients.data());
+            });
+    }
+
+    if (n <= BENCH_COFACTOR_MAX && Selected(options, "det-cofactor"))
+    {
+        // A expansão de ordem k faz k produtos e k determinantes de ordem k - 1
+        double products = 0;
+
+        for (int k = 2; k <= n; k++)
+            products = k * (products + 1);
+
+        bench.operation = "det-cofactor";
+        bench.flops = 2 * products;
+
+        Measure(
+            options, &bench, []() {},
+            [&]()
+            {
+                determinant = CalculateMatrixDeterminant(bench.x, n);
+            });
+    }
+
+    if (n <= BENCH_EXACT_MAX && Selected(options, "det-exact"))
+    {
+        static char digits[MTX_DETERMINANT_DIGITS * 64];
+
+        bench.operation = "det-exact";
+        bench.type = "inteiro";
+        bench.flops = 0;
+
+        Measure(
+            options, &bench, []() {},
+            [&]()
+            {
+                CalculateExactDeterminant(bench.x, n, digits, sizeof(digits));
+            });
+    }
+
+    FreeInputs(&bench);
+}
+
+// Mede o preenchimento paralelo de uma matriz n x n com cada distribuição de Random.h
+void RunRandomFills(const BenchmarkOptions *options, int n, int threads)
+{
+    if (!Selected(options, "random"))
+        return;
+
+    BenchmarkCase bench;
+    bench.operation = "random";
+    bench.shape = shapeNames[SHAPE_SQUARE];
+    bench.threads = threads;
+    bench.verified = -1;
+
+    PrepareInputs(&bench, n, n, n);
+
+    long long count = (long long)n * n;
+
+    bench.flops = 0;
+    bench.bytes = 8.0 * count;
+
+    // Cada execução continua o gerador, como fariam preenchimentos seguidos
+    Random random;
+    SeedRandom(&random, 1);
+
+    bench.type = "inteiro";
+
+    Measure(
+        options, &bench, []() {},
+        [&]()
+        {
+            FillRandomParallel(&random, bench.x, count, FillInputBlock);
+        });
+
+    bench.type = "real";
+
+    Measure(
+        options, &bench, []() {},
+        [&]()
+        {
+            FillRandomParallel(&random, bench.x, count, [](Random *stream, double *destination, long long length)
+            {
+                FillRandomReals(stream, destination, length, -1, 1);
+            });
+        });
+
+    bench.type = "normal";
+
+    Measure(
+        options, &bench, []() {},
+        [&]()
+        {
+            FillRandomParallel(&random, bench.x, count, [](Random *stream, double *destination, long long length)
+            {
+                FillRandomNormals(stream, destination, length, 0, 1);
+            });
+        });
+
+    FreeInputs(&bench);
+}
+
+// O CalculateMatrixDeterminant está em Matrix.h, que depende do gl_canvas2d.cpp,
+// e este por sua vez exige as funções de callback da interface, nunca chamadas aqui
+void render()
+{
+}
+
+void keyboard(int key)
+{
+}
+
+void keyboardUp(int key)
+{
+}
+
+void mouse(int button, int state, int wheel, int direction, int x, int y)
+{
+}
+
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options;
+    ParseOptions(argc, argv, &options);
+
+    SeedRandom(&globalRandom, 1);
+
+    output = fopen(options.output, "w");
+
+    if (output == NULL)
+    {
+        fprintf(stderr, "nao foi possivel abrir %s\n", options.output);
+        return 1;
+    }
+
+    time_t now = time(NULL);
+    char date[32];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    fprintf(output, "{\n  \"date\": \"%s\",\n  \"compiler\": \"%s\",\n  \"hardware_concurrency\": %u,\n  \"results\": [",
+            date, __VERSION__, std::thread::hardware_concurrency());
+
+    printf("%-16s %-9s %-7s %13s %3s %6s %14s %14s %9s %12s\n",
+           "operacao", "formato", "tipo", "tamanho", "thr", "reps", "ns/op", "desvio", "GFLOP/s", "bytes/s");
+
+    for (int t = 0; t < options.threadCount; t++)
+    {
+        parallelThreads = options.threads[t];
+        int threads = ParallelThreadCount();
+
+        for (int k = 0; k < options.sizeCount; k++)
+        {
+            for (int shape = 0; shape < SHAPE_NUM; shape++)
+                RunOperations(&options, options.sizes[k], shape, threads);
+
+            RunDeterminants(&options, options.sizes[k], threads);
+            RunRandomFills(&options, options.sizes[k], threads);
+        }
+    }
+
+    fprintf(output, "\n  ]\n}\n");
+    fclose(output);
+
+    printf("\nresultados gravados em %s\n", options.output);
+
+    return 0;
+}
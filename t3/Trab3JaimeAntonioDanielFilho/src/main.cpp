@@ -4,21 +4,76 @@
 //
 // A expressão sendo calculada é exibida no centro da janela, sendo as
 // matrizes X e Y para entrada e a matriz Z para o resultado. O tamanho
-// máximo das matrizes é 9.
+// máximo das matrizes é 1000. As matrizes que não cabem na janela ganham
+// barras de rolagem e os índices das linhas e das colunas. A roda do mouse
+// sobre as células amplia ou reduz a matriz; com Shift ela rola na vertical
+// e com Ctrl na horizontal. Reduzida além do tamanho do texto, a matriz é
+// exibida como um mapa de calor (azul para negativos e vermelho para positivos).
 //
 // No canto superior esquerdo, encontram-se 4 botões:
-// - Os botões X, +, - e Gauss Jordan servem para selecionar a operação a ser realizada
-// nas matrizes.
-// - O botão ? gera valores aleatórios e também um tamanho aleatório.
+// - Os botões X, +, -, Gauss Jordan e T servem para selecionar a operação a ser realizada
+// nas matrizes. As operações Gauss Jordan e T (transposta) utilizam apenas a matriz X.
+// - O botão \ resolve o sistema X * Z = Y. Com o botão Krylov selecionado, o sistema
+//   é resolvido pelos métodos iterativos (Gradiente Conjugado para X simétrica definida
+//   positiva e GMRES nos demais casos) e o histórico de convergência é exibido.
+// - Os botões ^ e exp calculam a potência X^k (sendo k digitado na caixa ao lado de ^)
+// e a exponencial da matriz X.
+// - O botão ? gera valores aleatórios e também um tamanho aleatório (até 9).
+// - O botão Exato alterna o cálculo exato dos determinantes de matrizes inteiras,
+//   que não sofrem com o limite de precisão do double. O Gauss Jordan de uma matriz
+//   inteira também passa a ser exato, com a matriz Z exibida em frações (e sem os
+//   passos da eliminação).
+// - Os botões double, int16 e int8 selecionam a precisão da multiplicação. Nas
+//   precisões inteiras, X e Y são quantizados e o erro máximo em relação ao
+//   resultado em double é exibido abaixo da matriz Z.
+// - O botão Verificar confere cada produto X * Y em double pelo algoritmo de
+//   Freivalds (com vetores aleatórios, sem refazer a multiplicação) e exibe
+//   abaixo da matriz Z se o resultado foi confirmado. Os produtos nas precisões
+//   int16 e int8 não são verificados.
+// - O botão Analise abre, abaixo da matriz X, o polinômio característico de X e
+//   as bases do seu núcleo, espaço coluna e espaço linha. Eles são calculados em
+//   segundo plano apenas com o painel aberto (as bases vêm da forma reduzida do
+//   Gauss Jordan, reaproveitada caso ele já tenha sido calculado para X).
 //
 // Os valores dos elementos das matrizes X e Y podem ser alterados com o teclado
-// ao clicar dentro de sua caixa. Isso também se aplica as suas dimensões.
+// ao clicar dentro de sua caixa. Isso também se aplica as suas dimensões. A tecla
+// Tab avança para a próxima célula (e depois para as dimensões) e as setas movem
+// a edição entre as células vizinhas. Ctrl+Z desfaz e Ctrl+Y refaz as alterações
+// de X e Y, inclusive as de dimensões e as do botão ?.
+//
+// As células também aceitam números complexos: a tecla i passa a digitação
+// para a parte imaginária (e de volta para a real), assim como o + ou o - que
+// segue os dígitos da parte real, então 3+4i e 3-4i são digitados como se
+// escrevem (o - antes dos dígitos muda o sinal da parte real), e a célula é
+// exibida como a+bi. Com alguma parte imaginária em X ou Y, o produto, a soma, a subtração,
+// a transposta, o Gauss Jordan e o sistema são calculados em aritmética
+// complexa, e o determinante também passa a ser complexo.
 //
 // O determinante é calculado para cada matriz sempre que ocorrer alguma alteração
 // e, baseado no contexto, ele pode assumir:
 // - ERROR: Caso não exista determinante para a determinada matriz (ou seja,
 //   a matriz não é quadrada).
 //
+// O resultado é calculado em segundo plano sobre uma cópia de X e Y, então a
+// janela continua respondendo durante operações demoradas. Enquanto isso, o
+// progresso é exibido abaixo dos botões e a matriz Z mantém o último resultado
+// válido. Uma nova alteração cancela o cálculo em andamento.
+//
+// O Gauss Jordan registra as operações de linha feitas na eliminação. A barra
+// abaixo da matriz Z percorre esses passos (arrastando ou com a roda do mouse
+// sobre ela) e a matriz Z exibe o estado da eliminação no passo escolhido.
+//
+// Ao fechar o programa, as matrizes, a operação selecionada, o resultado e os
+// determinantes já calculados são gravados no arquivo session.snp, que é
+// mapeado na memória na próxima execução para restaurar a área de trabalho
+// sem recalcular nada. Sem esse arquivo, as matrizes começam aleatórias.
+//
+// No Linux, o programa também pode servir de motor de cálculo para outros
+// programas. Executado com --servidor [socket], ele não abre a janela e
+// atende os pedidos recebidos pelo socket Unix (por padrão /tmp/the-matrix.sock).
+// Executado com --cliente [socket], a janela envia os cálculos a esse servidor
+// em vez de calculá-los no próprio processo.
+//
 // Ao passar o mouse sobre os elementos da matriz de resultado, os elementos
 // da matriz X e da matriz Y que resultaram naquele valor serão realçados.
 // *********************************************************************/
@@ -32,39 +87,126 @@
 #include <time.h>
 
 #include "gl_canvas2d.h"
+#include "Analysis.h"
 #include "Matrix.h"
 #include "Button.h"
+#include "History.h"
+#include "Operations.h"
+#include "Server.h"
+#include "Slider.h"
+#include "Worker.h"
+
+#define ELEMENT_SPACING 16
 
-#define OPERATION_NUM 4
+#define CHART_WIDTH 240
+#define CHART_HEIGHT 80
 
-#define OPERATION_MULTIPLY 0
-#define OPERATION_ADD 1
-#define OPERATION_SUBTRACT 2
-#define OPERATION_GAUSS_JORDAN 3
+// Memória máxima do histórico de alterações
+#define HISTORY_BUDGET (64 * 1024 * 1024)
 
-#define ELEMENT_SPACING 16
+// Teclas de desfazer (Ctrl+Z) e refazer (Ctrl+Y)
+#define KEY_UNDO 26
+#define KEY_REDO 25
+
+// Arquivo de sessão e suas seções (as seções das matrizes vêm de Matrix.h)
+#define SESSION_FILE "session.snp"
+#define SESSION_SNAPSHOT_STATE 16
+#define SESSION_SNAPSHOT_RESULT 17
+#define SESSION_SNAPSHOT_RESIDUALS 18
 
-#define ZERO_THRESHOLD 0.000001
+// Espaço acima e abaixo da expressão, reservado aos botões e aos textos da matriz Z
+#define EXPRESSION_MARGIN 160
+
+// Seleções da interface no arquivo de sessão
+typedef struct
+{
+    int32_t operation, precision, exponent;
+    int32_t exact, iterative, verify;
+} SessionSnapshot;
+
+// Informações do último resultado no arquivo de sessão, cujos valores são os da matriz Z
+typedef struct
+{
+    int32_t operation, precision, iterative;
+    int32_t iterations, converged;
+    int32_t verify, verified;
+    int32_t reserved;
+
+    double precisionError;
+    double verificationError;
+    char solveMethod[32];
+} ResultSnapshot;
 
 // variaveis globais
 int windowWidth = 1280, windowHeight = 720;
 
 int operation = OPERATION_MULTIPLY;
+int precision = PRECISION_DOUBLE;
+
+bool exact = false;
+bool iterative = false;
+bool verify = false;
+
+// Último cálculo concluído, cujo resultado é exibido na matriz Z
+Job *result = NULL;
+Worker worker;
+
+// Libera os jobs do worker e o resultado (FreeClientJob no modo --cliente)
+ReleaseFunction releaseJob = FreeJob;
+
+#ifdef __linux__
+// Servidor do modo --servidor e socket do servidor usado no modo --cliente (NULL calcula localmente)
+Server server;
+const char *serverPath = NULL;
+
+// Executa o cálculo no servidor em vez de no próprio processo
+// Os cálculos complexos, o Gauss Jordan exato e os passos registrados da eliminação
+// não fazem parte do protocolo, então esses cálculos continuam locais, assim como
+// os jobs sem memória compartilhada
+void ExecuteJobOnServer(void *work, Task *task)
+{
+    Job *job = (Job *)work;
+
+    if (job->complex || job->traced || (job->exact && job->operation == OPERATION_GAUSS_JORDAN) || job->shared == NULL)
+        ExecuteJob(job, task);
+    else
+        ExecuteServerJob(serverPath, job, SRV_PRIORITY_INTERACTIVE, task);
+}
+#endif
 
-bool success = false;
-char error[100];
+// Estados anteriores de X e Y
+History history;
+
+// Painel de análise de X: a última análise concluída, calculada em segundo plano
+// apenas com o painel aberto, e se X mudou desde o último envio
+bool analyzing = false;
+bool analysisStale = true;
+
+Analysis *analysis = NULL;
+Worker analysisWorker;
+
+// Passo da eliminação escolhido na barra e passo exibido na matriz Z
+Slider traceSlider;
+int traceStep = 0, shownTraceStep = 0;
 
 Matrix matrixX;
 Matrix matrixY;
 Matrix matrixZ;
 
+NumberBox exponentBox;
+
 Button operationButtons[OPERATION_NUM];
+Button precisionButtons[PRECISION_NUM];
 Button randomizeButton;
+Button exactButton;
+Button iterativeButton;
+Button verifyButton;
+Button analysisButton;
 
 // Gera tamanhos e elementos aleatórios para as matrizes
 void Randomize()
 {
-    int size = rand() % MTX_MAX_SIZE + 1;
+    int size = (int)BoundedRandom(&globalRandom, NextRandom(&globalRandom), MTX_RANDOM_SIZE) + 1;
 
     SetMatrixRows(&matrixX, size);
     SetMatrixColumns(&matrixX, size);
@@ -76,242 +218,532 @@ void Randomize()
     RandomizeMatrix(&matrixY);
 }
 
-// Multiplica a matrix X e a matriz Y
-void Multiply()
+// Registra no histórico o estado de X e Y, caso algum deles tenha sido alterado
+void RecordHistory()
 {
-    if (MatrixColumns(&matrixX) != MatrixRows(&matrixY))
-    {
-        success = false;
-        strcpy(error, "colunas X diferente de linhas Y");
+    Matrix *matrices[2] = {&matrixX, &matrixY};
 
-        return;
-    }
+    HistoryEntry *previous = CurrentHistoryEntry(&history);
 
-    int size = MatrixColumns(&matrixX);
+    if (previous != NULL && !IsMatrixEdited(&matrixX) && !IsMatrixEdited(&matrixY))
+        return;
 
-    int rows = MatrixRows(&matrixX);
-    int columns = MatrixColumns(&matrixY);
+    HistoryEntry *entry = BeginHistoryEntry(&history);
 
-    SetMatrixRows(&matrixZ, rows);
-    SetMatrixColumns(&matrixZ, columns);
+    bool changed = false;
 
-    for (int i = 0; i < rows; i++)
+    // Cada matriz ocupa dois registros: as partes reais e as imaginárias
+    for (int m = 0; m < 2; m++)
     {
-        for (int j = 0; j < columns; j++)
-        {
-            double result = 0;
+        if (RecordMatrix(matrices[m], &history, previous != NULL ? &previous->snapshots[2 * m] : NULL, &entry->snapshots[2 * m]))
+            changed = true;
+    }
 
-            for (int k = 0; k < size; k++)
-            {
-                result += MatrixValue(&matrixX, i, k) * MatrixValue(&matrixY, k, j);
-            }
+    if (changed)
+        CommitHistoryEntry(&history);
+    else
+        CancelHistoryEntry(&history);
+}
 
-            SetMatrixValue(&matrixZ, i, j, result);
-        }
-    }
+// Desfaz (steps = -1) ou refaz (steps = 1) as alterações de X e Y
+void StepEdits(int steps)
+{
+    Matrix *matrices[2] = {&matrixX, &matrixY};
+
+    // Alterações ainda não registradas seriam perdidas
+    RecordHistory();
+
+    HistoryEntry *from = CurrentHistoryEntry(&history);
+    HistoryEntry *to = StepHistory(&history, steps);
+
+    if (to == NULL)
+        return;
 
-    success = true;
+    for (int m = 0; m < 2; m++)
+        RestoreMatrix(matrices[m], &from->snapshots[2 * m], &to->snapshots[2 * m]);
 }
 
-// Adiciona a matrix X e a matriz Y
-void Add()
+// Envia ao segundo plano o cálculo da operação selecionada sobre uma cópia de X e Y
+// O cálculo anterior, caso ainda esteja em execução, é cancelado
+void CalculateResult()
 {
-    int rows = MatrixRows(&matrixX);
-    int columns = MatrixColumns(&matrixX);
+    int rowsX = MatrixRows(&matrixX), columnsX = MatrixColumns(&matrixX);
+    int rowsY = MatrixRows(&matrixY), columnsY = MatrixColumns(&matrixY);
+
+    Job *job = NULL;
+
+#ifdef __linux__
+    // No modo cliente, X e Y são lidos das células direto para a memória enviada ao servidor
+    if (serverPath != NULL)
+        job = CreateClientJob(operation, rowsX, columnsX, rowsY, columnsY);
+#endif
+
+    if (job == NULL)
+        job = CreateJob(operation, rowsX, columnsX, rowsY, columnsY);
 
-    if (rows != MatrixRows(&matrixY) || columns != MatrixColumns(&matrixY))
+    job->precision = precision;
+    job->exact = exact;
+    job->iterative = iterative;
+    job->verify = verify;
+    job->exponent = (unsigned int)exponentBox.value;
+
+    GetMatrixElements(&matrixX, job->x);
+    GetMatrixElements(&matrixY, job->y);
+
+    // A estrutura das matrizes pode ainda estar em cálculo, então o próprio cálculo a detecta
+    job->detectStructure = true;
+
+    if (matrixX.complex || matrixY.complex)
     {
-        success = false;
-        strcpy(error, "tamanho X diferente de tamanho Y");
+        SetJobComplex(job);
 
-        return;
+        GetMatrixImaginary(&matrixX, job->xi);
+        GetMatrixImaginary(&matrixY, job->yi);
     }
 
-    SetMatrixRows(&matrixZ, rows);
-    SetMatrixColumns(&matrixZ, columns);
+    // A eliminação complexa não registra os passos
+    job->traced = operation == OPERATION_GAUSS_JORDAN && !job->complex;
+
+    SubmitWork(&worker, job);
+}
 
-    for (int i = 0; i < rows; i++)
+// Exibe o resultado do último cálculo concluído, mantendo o anterior enquanto não houver um novo
+void ReceiveResult()
+{
+    Job *job = (Job *)TakeFinishedWork(&worker);
+
+    if (job == NULL)
+        return;
+
+    if (result != NULL)
+        releaseJob(result);
+
+    result = job;
+
+    if (result->success)
     {
-        for (int j = 0; j < columns; j++)
-        {
-            SetMatrixValue(&matrixZ, i, j, MatrixValue(&matrixX, i, j) + MatrixValue(&matrixY, i, j));
-        }
+        SetMatrixElements(&matrixZ, result->z, result->rowsZ, result->columnsZ, result->zi);
+        SetMatrixFractions(&matrixZ, result->fractions);
+    }
+
+    // O resultado corresponde ao último passo da eliminação
+    if (result->trace != NULL)
+    {
+        traceStep = shownTraceStep = result->trace->count;
+        traceSlider.value = 1;
     }
+}
+
+// Verifica se o último resultado possui passos de eliminação para percorrer
+bool HasTrace()
+{
+    return result != NULL && result->success && result->trace != NULL && result->trace->count > 0;
+}
+
+// Escolhe o passo da eliminação a ser exibido, limitado aos passos registrados
+void SelectTraceStep(int step)
+{
+    int count = result->trace->count;
+
+    traceStep = step < 0 ? 0 : step > count ? count : step;
+    traceSlider.value = (float)traceStep / count;
+}
+
+// Exibe na matriz Z o passo escolhido, caso ainda não seja o exibido
+// A reconstrução é feita uma vez por quadro, mesmo que a barra tenha sido arrastada várias vezes
+void ShowTraceStep()
+{
+    if (!HasTrace() || traceStep == shownTraceStep)
+        return;
+
+    Trace *trace = result->trace;
+
+    SetMatrixElements(&matrixZ, SeekTrace(trace, traceStep), trace->rows, trace->columns);
+
+    // Os passos intermediários não recalculam a estrutura e o determinante de Z,
+    // que continuam os do resultado até que o último passo volte a ser exibido
+    if (traceStep != trace->count)
+        matrixZ.changed = false;
+
+    shownTraceStep = traceStep;
+}
+
+// Desenha a barra dos passos da eliminação e a descrição do passo exibido
+void DrawTrace(float x, float y)
+{
+    char text[TEXT_BUFFER_SIZE];
+    char operationText[TEXT_BUFFER_SIZE];
+
+    Trace *trace = result->trace;
+
+    if (shownTraceStep > 0)
+        DescribeTraceOperation(&trace->operations[shownTraceStep - 1], operationText);
+    else
+        strcpy(operationText, "matriz X");
+
+    sprintf(text, "passo %d de %d: %s", shownTraceStep, trace->count, operationText);
 
-    success = true;
+    Color8(0, 0, 0);
+    CV::text(x, y, text);
+
+    traceSlider.x = x;
+    traceSlider.y = y + MTX_SPACING;
+
+    DrawSlider(&traceSlider);
 }
 
-// Subtrai a matrix X e a matriz Y
-void Subtract()
+// Envia ao segundo plano a análise de uma cópia de X
+// A forma reduzida do último resultado é reaproveitada quando ele é o Gauss Jordan da mesma matriz
+void CalculateAnalysis()
 {
     int rows = MatrixRows(&matrixX);
     int columns = MatrixColumns(&matrixX);
+    size_t size = (size_t)rows * columns * sizeof(double);
 
-    if (rows != MatrixRows(&matrixY) || columns != MatrixColumns(&matrixY))
+    Analysis *work = CreateAnalysis(rows, columns);
+
+    GetMatrixElements(&matrixX, work->x);
+    work->exact = exact;
+
+    if (result != NULL && result->success && !result->complex &&
+        result->operation == OPERATION_GAUSS_JORDAN && result->exact == exact &&
+        result->rowsX == rows && result->columnsX == columns &&
+        memcmp(result->x, work->x, size) == 0)
     {
-        success = false;
-        strcpy(error, "tamanho X diferente de tamanho Y");
+        work->reduced = (double *)malloc(size + sizeof(double));
+        memcpy(work->reduced, result->z, size);
 
-        return;
+        work->exact = result->fractions != NULL;
     }
 
-    SetMatrixRows(&matrixZ, rows);
-    SetMatrixColumns(&matrixZ, columns);
+    SubmitWork(&analysisWorker, work);
+}
 
-    for (int i = 0; i < rows; i++)
-    {
-        for (int j = 0; j < columns; j++)
-        {
-            SetMatrixValue(&matrixZ, i, j, MatrixValue(&matrixX, i, j) - MatrixValue(&matrixY, i, j));
-        }
-    }
+// Recebe a última análise concluída, descartando a anterior
+void ReceiveAnalysis()
+{
+    Analysis *work = (Analysis *)TakeFinishedWork(&analysisWorker);
 
-    success = true;
+    if (work == NULL)
+        return;
+
+    if (analysis != NULL)
+        FreeAnalysis(analysis);
+
+    analysis = work;
 }
 
-// Troca os elementos de duas linhas da matriz Z
-void SwapRows(int i1, int i2)
+// Desenha uma linha do painel de análise, cortada na largura disponível
+void DrawAnalysisLine(float x, float *y, float width, const char *label, const char *content)
 {
-    for (int j = 0; j < MatrixRows(&matrixZ); j++)
-    {
-        double temp = MatrixValue(&matrixZ, i1, j);
+    char text[TEXT_BUFFER_SIZE];
 
-        SetMatrixValue(&matrixZ, i1, j, MatrixValue(&matrixZ, i2, j));
-        SetMatrixValue(&matrixZ, i2, j, temp);
-    }
+    snprintf(text, sizeof(text), "%s%s", label, content);
+    FitText(text, width);
+
+    CV::text(x, *y, text);
+
+    *y += FONT_SIZE + MTX_SPACING;
 }
 
-// Encontra o pivo de uma linha da matriz Z
-// (isto é, o primeiro elemento da direita para a esquerda diferente de zero)
-int SelectGaussianPivot(int i)
+// Desenha o painel de análise de X: o polinômio característico, o posto e as bases
+void DrawAnalysis(float x, float y, float width)
 {
-    for (int j = 0; j < MatrixRows(&matrixZ) && j < MatrixColumns(&matrixZ); j++)
+    char text[TEXT_BUFFER_SIZE];
+
+    Color8(0, 0, 0);
+
+    if (matrixX.complex)
     {
-        if (fabs(MatrixValue(&matrixZ, i, j)) > ZERO_THRESHOLD)
-        {
-            return j;
-        }
+        DrawAnalysisLine(x, &y, width, "analise sem suporte a complexos", "");
+        return;
+    }
+
+    if (analysisStale || IsWorkerBusy(&analysisWorker) || analysis == NULL || !analysis->success)
+    {
+        sprintf(text, "%.0f%%", 100 * WorkerProgress(&analysisWorker));
+        DrawAnalysisLine(x, &y, width, "analisando... ", text);
+        return;
+    }
+
+    if (analysis->rows == analysis->columns)
+    {
+        DescribePolynomial(analysis, text, sizeof(text));
+        DrawAnalysisLine(x, &y, width, "p(t) = ", text);
+    }
+    else
+    {
+        DrawAnalysisLine(x, &y, width, "p(t) = ERROR", "");
     }
 
-    return -1;
+    sprintf(text, "posto %d, nulidade %d", analysis->rank, analysis->columns - analysis->rank);
+    DrawAnalysisLine(x, &y, width, text, "");
+
+    DescribeVectors(analysis->nullspace, analysis->columns - analysis->rank, analysis->columns, text, sizeof(text));
+    DrawAnalysisLine(x, &y, width, "nucleo: ", text);
+
+    DescribeVectors(analysis->columnSpace, analysis->rank, analysis->rows, text, sizeof(text));
+    DrawAnalysisLine(x, &y, width, "colunas: ", text);
+
+    DescribeVectors(analysis->rowSpace, analysis->rank, analysis->columns, text, sizeof(text));
+    DrawAnalysisLine(x, &y, width, "linhas: ", text);
 }
 
-// Elimina o pivo de todas as outras linhas da matriz Z
-void EliminateGaussianPivot(int row, int pivot)
+// Encerra os cálculos em segundo plano antes do fim do programa
+void FinishWorker()
 {
-    for (int i = 0; i < MatrixRows(&matrixZ); i++)
-    {
-        if (i != row)
-        {
-            double coefficient = MatrixValue(&matrixZ, i, pivot) / MatrixValue(&matrixZ, row, pivot);
+    StopWorker(&worker);
+    StopWorker(&analysisWorker);
 
-            for (int j = 0; j < MatrixColumns(&matrixZ); j++)
-            {
-                SetMatrixValue(&matrixZ, i, j, MatrixValue(&matrixZ, i, j) - coefficient * MatrixValue(&matrixZ, row, j));
-            }
-        }
-    }
+    StopWorker(&matrixX.worker);
+    StopWorker(&matrixY.worker);
+    StopWorker(&matrixZ.worker);
 }
 
-// Redução da matriz X pelo método de Gauss Jordan
-void GaussJordan()
+// Grava o arquivo de sessão com o estado atual da área de trabalho
+void SaveSession()
 {
-    int rows = MatrixRows(&matrixX);
-    int columns = MatrixColumns(&matrixX);
+    // A matriz Z volta ao resultado final caso exiba um passo da eliminação
+    if (HasTrace() && traceStep != result->trace->count)
+    {
+        SelectTraceStep(result->trace->count);
+        ShowTraceStep();
+    }
+
+    // A sessão guarda a estrutura e o determinante já calculados para os valores atuais
+    FinishMatrixUpdate(&matrixX);
+    FinishMatrixUpdate(&matrixY);
+    FinishMatrixUpdate(&matrixZ);
+
+    SnapshotWriter writer;
+
+    if (!BeginSnapshotFile(&writer, SESSION_FILE))
+        return;
+
+    SessionSnapshot state;
+    memset(&state, 0, sizeof(state));
+
+    state.operation = operation;
+    state.precision = precision;
+    state.exponent = (int32_t)exponentBox.value;
+    state.exact = exact;
+    state.iterative = iterative;
+    state.verify = verify;
 
-    SetMatrixRows(&matrixZ, rows);
-    SetMatrixColumns(&matrixZ, columns);
+    WriteSnapshotSection(&writer, SESSION_SNAPSHOT_STATE, 0, &state, sizeof(state));
 
-    for (int i = 0; i < rows; i++)
+    SaveMatrixSnapshot(&matrixX, &writer);
+    SaveMatrixSnapshot(&matrixY, &writer);
+
+    if (result != NULL && result->success)
     {
-        for (int j = 0; j < columns; j++)
-        {
-            SetMatrixValue(&matrixZ, i, j, MatrixValue(&matrixX, i, j));
-        }
+        ResultSnapshot info;
+        memset(&info, 0, sizeof(info));
+
+        info.operation = result->operation;
+        info.precision = result->precision;
+        info.iterative = result->iterative;
+        info.iterations = result->solveHistory.iterations;
+        info.converged = result->solveHistory.converged;
+        info.precisionError = result->precisionError;
+        info.verify = result->verify;
+        info.verified = result->verified;
+        info.verificationError = result->verificationError;
+        strcpy(info.solveMethod, result->solveMethod);
+
+        int residuals = info.iterations < KRY_HISTORY_SIZE ? info.iterations : KRY_HISTORY_SIZE;
+
+        WriteSnapshotSection(&writer, SESSION_SNAPSHOT_RESULT, 0, &info, sizeof(info));
+        WriteSnapshotSection(&writer, SESSION_SNAPSHOT_RESIDUALS, 0, result->solveHistory.residuals, residuals * sizeof(double));
+
+        SaveMatrixSnapshot(&matrixZ, &writer);
     }
 
-    for (int i = 0; i < rows; i++)
+    if (!EndSnapshotFile(&writer))
+        printf("\nNao foi possivel gravar %s", SESSION_FILE);
+}
+
+// Restaura o último resultado do arquivo de sessão
+// Retorna falso caso o arquivo não possua um resultado
+bool LoadResult(const Snapshot *snapshot)
+{
+    const ResultSnapshot *info = (const ResultSnapshot *)FindSnapshotSection(snapshot, SESSION_SNAPSHOT_RESULT, 0, sizeof(ResultSnapshot));
+
+    if (info == NULL ||
+        info->operation < 0 || info->operation >= OPERATION_NUM ||
+        info->precision < 0 || info->precision >= PRECISION_NUM ||
+        info->iterations < 0)
     {
-        int pivot = SelectGaussianPivot(i);
+        return false;
+    }
 
-        if (pivot != -1)
-        {
-            EliminateGaussianPivot(i, pivot);
-            SwapRows(i, pivot);
-        }
+    int residuals = info->iterations < KRY_HISTORY_SIZE ? info->iterations : KRY_HISTORY_SIZE;
+
+    const double *values = (const double *)FindSnapshotSection(snapshot, SESSION_SNAPSHOT_RESIDUALS, 0, residuals * sizeof(double));
+
+    if ((values == NULL && residuals > 0) || !LoadMatrixSnapshot(&matrixZ, snapshot))
+        return false;
+
+    result = CreateJob(info->operation, 0, 0, 0, 0);
+
+    result->precision = info->precision;
+    result->iterative = info->iterative != 0;
+    result->precisionError = info->precisionError;
+    result->verify = info->verify != 0;
+    result->verified = info->verified != 0;
+    result->verificationError = info->verificationError;
+
+    result->solveHistory.iterations = info->iterations;
+    result->solveHistory.converged = info->converged != 0;
+    if (residuals > 0)
+        memcpy(result->solveHistory.residuals, values, residuals * sizeof(double));
+
+    memcpy(result->solveMethod, info->solveMethod, sizeof(result->solveMethod));
+    result->solveMethod[sizeof(result->solveMethod) - 1] = '\0';
+
+    GetMatrixElements(&matrixZ, AllocateJobResult(result, MatrixRows(&matrixZ), MatrixColumns(&matrixZ)));
+
+    if (matrixZ.complex)
+    {
+        result->complex = true;
+        GetMatrixImaginary(&matrixZ, AllocateJobImaginary(result));
     }
 
-    for (int k = 0; k < rows; k++)
+    // Um resultado exato volta com as suas frações
+    size_t count = (size_t)MatrixRows(&matrixZ) * MatrixColumns(&matrixZ);
+    result->fractions = (Fraction *)malloc((count + 1) * sizeof(Fraction));
+
+    result->exact = exact;
+
+    if (!GetMatrixFractions(&matrixZ, result->fractions))
     {
-        double coefficient = MatrixValue(&matrixZ, k, k);
+        free(result->fractions);
+        result->fractions = NULL;
+    }
 
-        if (fabs(coefficient) > ZERO_THRESHOLD)
-        {
-            for (int j = 0; j < columns; j++)
-            {
-                SetMatrixValue(&matrixZ, k, j, MatrixValue(&matrixZ, k, j) / coefficient);
-            }
-        }
+    result->success = true;
+
+    return true;
+}
+
+// Restaura a área de trabalho gravada no arquivo de sessão
+// Retorna falso caso o arquivo não exista ou não seja válido
+bool LoadSession()
+{
+    Snapshot snapshot;
+
+    if (!OpenSnapshot(&snapshot, SESSION_FILE))
+        return false;
+
+    const SessionSnapshot *state = (const SessionSnapshot *)FindSnapshotSection(&snapshot, SESSION_SNAPSHOT_STATE, 0, sizeof(SessionSnapshot));
+
+    bool loaded = state != NULL &&
+                  state->operation >= 0 && state->operation < OPERATION_NUM &&
+                  state->precision >= 0 && state->precision < PRECISION_NUM &&
+                  state->exponent >= 0 &&
+                  LoadMatrixSnapshot(&matrixX, &snapshot) &&
+                  LoadMatrixSnapshot(&matrixY, &snapshot);
+
+    if (loaded)
+    {
+        operation = state->operation;
+        precision = state->precision;
+        exact = state->exact != 0;
+        iterative = state->iterative != 0;
+        verify = state->verify != 0;
+
+        SetNumberBoxValue(&exponentBox, state->exponent);
+        matrixZ.exact = exact;
+
+        // Sem o resultado gravado, ele é calculado novamente
+        if (!LoadResult(&snapshot))
+            matrixX.changed = true;
     }
 
-    success = true;
+    CloseSnapshot(&snapshot);
+
+    return loaded;
 }
 
-// Calcula o resultado baseado na operação selecionada
-void CalculateResult()
+// Realça as posições que resultaram no elemento sobre o qual está o mouse
+void HighlightResult()
 {
-    switch (operation)
+    if (result == NULL || !result->success)
+        return;
+
+    int i = matrixZ.hoveredI;
+    int j = matrixZ.hoveredJ;
+
+    if (i == -1 || i >= MatrixRows(&matrixZ) || j >= MatrixColumns(&matrixZ))
+        return;
+
+    Color8(203, 194, 255);
+    HighlightMatrix(&matrixZ, i, j, i, j);
+
+    switch (result->operation)
     {
     case OPERATION_MULTIPLY:
-        Multiply();
+        Color8(184, 223, 220);
+        HighlightMatrix(&matrixX, i, 0, i, MatrixColumns(&matrixX) - 1);
+
+        Color8(155, 205, 255);
+        HighlightMatrix(&matrixY, 0, j, MatrixRows(&matrixY) - 1, j);
         break;
     case OPERATION_ADD:
-        Add();
-        break;
     case OPERATION_SUBTRACT:
-        Subtract();
+        Color8(184, 223, 220);
+        HighlightMatrix(&matrixX, i, j, i, j);
+
+        Color8(155, 205, 255);
+        HighlightMatrix(&matrixY, i, j, i, j);
         break;
-    case OPERATION_GAUSS_JORDAN:
-        GaussJordan();
+    case OPERATION_TRANSPOSE:
+        Color8(184, 223, 220);
+        HighlightMatrix(&matrixX, j, i, j, i);
         break;
     }
 }
 
-// Realça as posições que resultaram no elemento sobre o qual está o mouse
-void HighlightResult()
+// Desenha o histórico de convergência do último sistema resolvido pelos métodos de Krylov
+void DrawConvergence(float x, float y)
 {
-    if (!success)
+    char text[TEXT_BUFFER_SIZE];
+
+    KrylovHistory *solveHistory = &result->solveHistory;
+
+    int count = solveHistory->iterations < KRY_HISTORY_SIZE ? solveHistory->iterations : KRY_HISTORY_SIZE;
+    double last = count > 0 ? solveHistory->residuals[count - 1] : 0;
+
+    sprintf(text, "%s: %d iteracoes, residuo %.2e%s",
+            result->solveMethod,
+            solveHistory->iterations > 0 ? solveHistory->iterations - 1 : 0,
+            last,
+            solveHistory->converged ? "" : " (nao convergiu)");
+
+    Color8(0, 0, 0);
+    CV::text(x, y, text);
+
+    if (count < 2)
         return;
 
-    for (int i = 0; i < MatrixRows(&matrixZ); i++)
+    // Gráfico do log10 do resíduo por iteração, de 1 até 1e-16
+    y += MTX_SPACING;
+
+    Color8(200, 200, 200);
+    CV::rect(x, y, x + CHART_WIDTH, y + CHART_HEIGHT);
+
+    Color8(255, 145, 3);
+
+    for (int k = 1; k < count; k++)
     {
-        for (int j = 0; j < MatrixColumns(&matrixZ); j++)
-        {
-            if (matrixZ.boxes[i][j].hovering)
-            {
-                Color8(203, 194, 255);
-                HighlightMatrix(&matrixZ, i, j, i, j);
-
-                switch (operation)
-                {
-                case OPERATION_MULTIPLY:
-                    Color8(184, 223, 220);
-                    HighlightMatrix(&matrixX, i, 0, i, MatrixColumns(&matrixX) - 1);
-
-                    Color8(155, 205, 255);
-                    HighlightMatrix(&matrixY, 0, j, MatrixRows(&matrixY) - 1, j);
-                    break;
-                case OPERATION_ADD:
-                case OPERATION_SUBTRACT:
-                    Color8(184, 223, 220);
-                    HighlightMatrix(&matrixX, i, j, i, j);
-
-                    Color8(155, 205, 255);
-                    HighlightMatrix(&matrixY, i, j, i, j);
-                    break;
-                }
-            }
-        }
+        double from = log10(fmax(solveHistory->residuals[k - 1], 1e-16));
+        double to = log10(fmax(solveHistory->residuals[k], 1e-16));
+
+        CV::line(
+            x + CHART_WIDTH * (k - 1) / (count - 1),
+            y + CHART_HEIGHT * fmin(-from / 16, 1),
+            x + CHART_WIDTH * k / (count - 1),
+            y + CHART_HEIGHT * fmin(-to / 16, 1));
     }
 }
 
@@ -334,10 +766,86 @@ void DrawButtons()
 
     x += 3 * ELEMENT_SPACING;
 
+    for (int i = 0; i < PRECISION_NUM; i++)
+    {
+        precisionButtons[i].x = x;
+        precisionButtons[i].y = y;
+
+        x += ELEMENT_SPACING;
+        x += ButtonWidth(&precisionButtons[i]);
+
+        DrawButton(&precisionButtons[i], precision == i);
+    }
+
+    x += 3 * ELEMENT_SPACING;
+
     randomizeButton.y = y;
     randomizeButton.x = x;
 
     DrawButton(&randomizeButton, false);
+
+    x += ELEMENT_SPACING;
+    x += ButtonWidth(&randomizeButton);
+
+    exactButton.y = y;
+    exactButton.x = x;
+
+    DrawButton(&exactButton, exact);
+
+    x += ELEMENT_SPACING;
+    x += ButtonWidth(&exactButton);
+
+    iterativeButton.y = y;
+    iterativeButton.x = x;
+
+    DrawButton(&iterativeButton, iterative);
+
+    x += ELEMENT_SPACING;
+    x += ButtonWidth(&iterativeButton);
+
+    verifyButton.y = y;
+    verifyButton.x = x;
+
+    DrawButton(&verifyButton, verify);
+
+    x += ELEMENT_SPACING;
+    x += ButtonWidth(&verifyButton);
+
+    analysisButton.y = y;
+    analysisButton.x = x;
+
+    DrawButton(&analysisButton, analyzing);
+}
+
+// Limita as janelas das matrizes para que a expressão caiba na largura disponível
+// As matrizes menores do que a sua parte cedem o espaço que sobra para as demais
+void FitMatrices(Matrix **matrices, int count, float width, float height)
+{
+    float share = width / count;
+    float slack = 0;
+    int larger = 0;
+
+    float frames[3], needed[3];
+
+    for (int k = 0; k < count; k++)
+    {
+        // Tudo o que a matriz ocupa além das células
+        frames[k] = MatrixWidth(matrices[k]) - matrices[k]->view.width;
+        needed[k] = frames[k] + MatrixContentWidth(matrices[k]);
+
+        if (needed[k] <= share)
+            slack += share - needed[k];
+        else
+            larger++;
+    }
+
+    for (int k = 0; k < count; k++)
+    {
+        float available = needed[k] <= share ? needed[k] : share + slack / larger;
+        float frameHeight = MatrixHeight(matrices[k]) - matrices[k]->view.height;
+
+        SetMatrixViewSize(matrices[k], available - frames[k], height - frameHeight);
+    }
 }
 
 // Desenha a expressão
@@ -346,6 +854,22 @@ void DrawExpression()
     float x = 2 * ELEMENT_SPACING;
     float y = windowHeight / 2.0f;
 
+    // Largura ocupada pelas margens, pelos operadores e pela caixa do expoente
+    float operators = 4 * ELEMENT_SPACING;
+
+    operators += TextLength(operationButtons[operation].label) + 2 * ELEMENT_SPACING;
+    operators += TextLength("=") + 2 * ELEMENT_SPACING;
+
+    if (operation == OPERATION_POWER)
+        operators += NumberBoxWidth(&exponentBox) + ELEMENT_SPACING;
+
+    Matrix *matrices[3] = {&matrixX, &matrixY, &matrixZ};
+
+    if (IsUnaryOperation(operation))
+        matrices[1] = &matrixZ;
+
+    FitMatrices(matrices, IsUnaryOperation(operation) ? 2 : 3, windowWidth - operators, windowHeight - 2 * EXPRESSION_MARGIN);
+
     matrixX.x = x;
     matrixX.y = y + MatrixHeight(&matrixX) / 2;
 
@@ -357,7 +881,18 @@ void DrawExpression()
     x += TextLength(operationButtons[operation].label);
     x += ELEMENT_SPACING;
 
-    if (operation != OPERATION_GAUSS_JORDAN)
+    if (operation == OPERATION_POWER)
+    {
+        exponentBox.x = x;
+        exponentBox.y = y + NumberBoxHeight() / 2;
+
+        DrawNumberBox(&exponentBox);
+
+        x += NumberBoxWidth(&exponentBox);
+        x += ELEMENT_SPACING;
+    }
+
+    if (!IsUnaryOperation(operation))
     {
         matrixY.x = x;
         matrixY.y = y + MatrixHeight(&matrixY) / 2;
@@ -378,44 +913,144 @@ void DrawExpression()
 
     DrawMatrix(&matrixX);
 
-    if (operation != OPERATION_GAUSS_JORDAN)
+    if (!IsUnaryOperation(operation))
     {
         DrawMatrix(&matrixY);
     }
 
-    if (success)
+    // O painel ocupa a área abaixo de X, até o início dos textos da matriz Z
+    if (analyzing)
+    {
+        DrawAnalysis(matrixX.x, matrixX.y + FONT_SIZE + MTX_SPACING, matrixZ.x - ELEMENT_SPACING - matrixX.x);
+    }
+
+    if (result == NULL)
+        return;
+
+    if (result->success)
     {
         DrawMatrix(&matrixZ);
+
+        // Linha dos textos abaixo da matriz Z
+        float textY = matrixZ.y + FONT_SIZE + MTX_SPACING;
+
+        if (result->operation == OPERATION_MULTIPLY && result->precision != PRECISION_DOUBLE)
+        {
+            char errorText[TEXT_BUFFER_SIZE];
+            sprintf(errorText, "erro maximo (%s) = %f", precisionButtons[result->precision].label, result->precisionError);
+
+            Color8(0, 0, 0);
+            CV::text(matrixZ.x, textY, errorText);
+
+            textY += FONT_SIZE + MTX_SPACING;
+        }
+
+        if (result->operation == OPERATION_MULTIPLY && result->verify && result->precision != PRECISION_DOUBLE)
+        {
+            Color8(0, 0, 0);
+            CV::text(matrixZ.x, textY, "Freivalds: nao verificado (apenas na precisao double)");
+        }
+        else if (result->operation == OPERATION_MULTIPLY && result->verify)
+        {
+            char verificationText[TEXT_BUFFER_SIZE];
+            sprintf(verificationText, "Freivalds (%d vetores): %s, erro relativo %.2e",
+                    FREIVALDS_TRIALS, result->verified ? "confirmado" : "DIVERGENTE", result->verificationError);
+
+            if (result->verified)
+                Color8(0, 0, 0);
+            else
+                Color8(255, 0, 0);
+
+            CV::text(matrixZ.x, textY, verificationText);
+        }
+
+        if (result->operation == OPERATION_SOLVE && result->iterative)
+        {
+            DrawConvergence(matrixZ.x, textY);
+        }
+
+        if (HasTrace())
+        {
+            DrawTrace(matrixZ.x, textY);
+        }
     }
     else
     {
         Color8(255, 0, 0);
-        CV::text(x, y + FONT_SIZE / 2, error);
+        CV::text(x, y + FONT_SIZE / 2, result->error);
     }
 }
 
+// Desenha o progresso do cálculo em segundo plano, caso exista algum
+void DrawProgress()
+{
+    if (!IsWorkerBusy(&worker))
+        return;
+
+    char text[TEXT_BUFFER_SIZE];
+    sprintf(text, "calculando... %.0f%%", 100 * WorkerProgress(&worker));
+
+    Color8(0, 0, 0);
+    CV::text(2 * ELEMENT_SPACING, 2 * (ELEMENT_SPACING + ButtonHeight()), text);
+}
+
 // funcao chamada continuamente. Deve-se controlar o que desenhar por meio de variaveis
 // globais que podem ser setadas pelo metodo keyboard()
 void render()
 {
-    if (matrixX.changed || matrixY.changed)
+    RecordHistory();
+
+    bool changed = matrixX.changed || matrixY.changed;
+
+    if (matrixX.changed)
+        analysisStale = true;
+
+    // A indicação de valores complexos das entradas precisa estar atualizada antes do cálculo
+    UpdateMatrix(&matrixX);
+    UpdateMatrix(&matrixY);
+
+    if (changed)
     {
         CalculateResult();
     }
 
-    UpdateMatrix(&matrixX);
-    UpdateMatrix(&matrixY);
+    ReceiveResult();
+    ShowTraceStep();
     UpdateMatrix(&matrixZ);
 
+    // A análise só é calculada com o painel aberto e, com o Gauss Jordan selecionado,
+    // espera pelo resultado para aproveitar a forma reduzida em vez de refazer a eliminação
+    bool reducing = operation == OPERATION_GAUSS_JORDAN && IsWorkerBusy(&worker);
+
+    if (analyzing && analysisStale && !matrixX.complex && !reducing)
+    {
+        CalculateAnalysis();
+        analysisStale = false;
+    }
+
+    ReceiveAnalysis();
+
     DrawButtons();
     DrawExpression();
+    DrawProgress();
 }
 
 // funcao chamada toda vez que uma tecla for pressionada
 void keyboard(int key)
 {
+    if (key == KEY_UNDO || key == KEY_REDO)
+    {
+        StepEdits(key == KEY_UNDO ? -1 : 1);
+        return;
+    }
+
     ProccessMatrixInput(&matrixX, key);
     ProccessMatrixInput(&matrixY, key);
+
+    if (operation == OPERATION_POWER && ProccessNumberBoxInput(&exponentBox, key))
+    {
+        CalculateResult();
+    }
 }
 
 // funcao chamada toda vez que uma tecla for liberada
@@ -429,16 +1064,55 @@ void mouse(int button, int state, int wheel, int direction, int x, int y)
 {
     printf("\nmouse %d %d %d %d %d %d", button, state, wheel, direction, x, y);
 
+    if (wheel != -2)
+    {
+        // Sobre a barra, a roda avança ou volta um passo da eliminação
+        if (HasTrace() && traceSlider.hovering)
+        {
+            SelectTraceStep(traceStep + (direction > 0 ? 1 : -1));
+            return;
+        }
+
+        int modifiers = glutGetModifiers();
+
+        ProccessMatrixWheel(&matrixX, x, y, direction, modifiers);
+
+        if (!IsUnaryOperation(operation))
+            ProccessMatrixWheel(&matrixY, x, y, direction, modifiers);
+
+        ProccessMatrixWheel(&matrixZ, x, y, direction, modifiers);
+        return;
+    }
+
     ProccessMatrixMouse(&matrixX, x, y, button, state);
     ProccessMatrixMouse(&matrixY, x, y, button, state);
     ProccessMatrixMouse(&matrixZ, x, y, button, state);
 
+    if (HasTrace() && ProccessSliderMouse(&traceSlider, x, y, button, state))
+    {
+        SelectTraceStep((int)lroundf(traceSlider.value * result->trace->count));
+    }
+
+    if (operation == OPERATION_POWER)
+    {
+        ProccessNumberBoxMouse(&exponentBox, x, y, button, state);
+    }
+
     for (int i = 0; i < OPERATION_NUM; i++)
     {
         ProccessButtonMouse(&operationButtons[i], x, y);
     }
 
+    for (int i = 0; i < PRECISION_NUM; i++)
+    {
+        ProccessButtonMouse(&precisionButtons[i], x, y);
+    }
+
     ProccessButtonMouse(&randomizeButton, x, y);
+    ProccessButtonMouse(&exactButton, x, y);
+    ProccessButtonMouse(&iterativeButton, x, y);
+    ProccessButtonMouse(&verifyButton, x, y);
+    ProccessButtonMouse(&analysisButton, x, y);
 
     if (button == 0 && state == 0)
     {
@@ -451,30 +1125,109 @@ void mouse(int button, int state, int wheel, int direction, int x, int y)
             }
         }
 
+        for (int i = 0; i < PRECISION_NUM; i++)
+        {
+            if (precisionButtons[i].hovering)
+            {
+                precision = i;
+                CalculateResult();
+            }
+        }
+
         if (randomizeButton.hovering)
         {
             Randomize();
         }
+
+        if (exactButton.hovering)
+        {
+            exact = !exact;
+
+            SetMatrixExact(&matrixX, exact);
+            SetMatrixExact(&matrixY, exact);
+            SetMatrixExact(&matrixZ, exact);
+        }
+
+        if (iterativeButton.hovering)
+        {
+            iterative = !iterative;
+            CalculateResult();
+        }
+
+        if (verifyButton.hovering)
+        {
+            verify = !verify;
+            CalculateResult();
+        }
+
+        if (analysisButton.hovering)
+        {
+            analyzing = !analyzing;
+        }
     }
 }
 
-int main(void)
+int main(int argc, char **argv)
 {
-    srand(time(NULL));
+#ifdef __linux__
+    if (argc > 1 && strcmp(argv[1], "--servidor") == 0)
+        return RunServer(&server, argc > 2 ? argv[2] : SRV_SOCKET_PATH) ? 0 : 1;
+
+    if (argc > 1 && strcmp(argv[1], "--cliente") == 0)
+        serverPath = argc > 2 ? argv[2] : SRV_SOCKET_PATH;
+#endif
+
+    SeedRandom(&globalRandom, time(NULL));
+
+    InitializeHistory(&history, 4, HISTORY_BUDGET);
+
+    WorkFunction execute = ExecuteJob;
+
+#ifdef __linux__
+    if (serverPath != NULL)
+    {
+        execute = ExecuteJobOnServer;
+        releaseJob = FreeClientJob;
+    }
+#endif
+
+    StartWorker(&worker, execute, releaseJob);
+    StartWorker(&analysisWorker, ExecuteAnalysis, FreeAnalysis);
+    atexit(FinishWorker);
+    atexit(SaveSession);
 
     InitializeMatrix(&matrixX, 'x', 4, 4, false, "%.0f");
     InitializeMatrix(&matrixY, 'y', 4, 4, false, "%.0f");
     InitializeMatrix(&matrixZ, 'z', 0, 0, true, "%.2f");
 
-    RandomizeMatrix(&matrixX);
-    RandomizeMatrix(&matrixY);
+    InitializeSlider(&traceSlider, CHART_WIDTH, 1);
+
+    InitializeNumberBox(&exponentBox, 2, 0, INT_MAX, false, "%.0f");
+
+    if (!LoadSession())
+    {
+        RandomizeMatrix(&matrixX);
+        RandomizeMatrix(&matrixY);
+    }
 
     InitializeButton(&operationButtons[OPERATION_MULTIPLY], "X");
     InitializeButton(&operationButtons[OPERATION_ADD], "+");
     InitializeButton(&operationButtons[OPERATION_SUBTRACT], "-");
     InitializeButton(&operationButtons[OPERATION_GAUSS_JORDAN], "Gauss Jordan");
+    InitializeButton(&operationButtons[OPERATION_TRANSPOSE], "T");
+    InitializeButton(&operationButtons[OPERATION_POWER], "^");
+    InitializeButton(&operationButtons[OPERATION_EXPONENTIAL], "exp");
+    InitializeButton(&operationButtons[OPERATION_SOLVE], "\\");
+
+    InitializeButton(&precisionButtons[PRECISION_DOUBLE], "double");
+    InitializeButton(&precisionButtons[PRECISION_INT16], "int16");
+    InitializeButton(&precisionButtons[PRECISION_INT8], "int8");
 
     InitializeButton(&randomizeButton, "?");
+    InitializeButton(&exactButton, "Exato");
+    InitializeButton(&iterativeButton, "Krylov");
+    InitializeButton(&verifyButton, "Verificar");
+    InitializeButton(&analysisButton, "Analise");
 
     CV::init(&windowWidth, &windowHeight, "The Matrix");
     CV::run();